@@ -0,0 +1,11 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofApp.h"
+
+int main()
+{
+	// No window: the benchmark only exercises the input path, so it runs headless
+	ofAppNoWindow window;
+	ofSetupOpenGL(&window, 1024, 768, OF_WINDOW);
+	ofRunApp(new ofApp());
+}
@@ -0,0 +1,753 @@
+#include "ofApp.h"
+
+void ofApp::setup()
+{
+	// Widgets, laid out on a grid
+	for (int i = 0; i < BENCH_NUM_STAINS; i++)
+	{
+		m_stains[i].setup(16, "Stain " + ofToString(i), 0.05f);
+		m_stains[i].setOrigin((i % 10 + 0.5f) / 10, (i / 10 + 0.5f) / (BENCH_NUM_STAINS / 10 + 1));
+		m_stains[i].setActive(true);
+	}
+	for (int i = 0; i < BENCH_NUM_BUTTONS; i++)
+	{
+		m_buttons[i].setup(0x00FF00, 0xFF0000);
+		m_buttons[i].setPosition(ofGetWidth() * (i + 0.5f) / BENCH_NUM_BUTTONS, ofGetHeight() * 0.1f);
+		m_buttons[i].setActive(true);
+	}
+	ofxTactoSHPMNode* root = new ofxTactoSHPMNode(ofColor(128));
+	m_menuNodes.push_back(root);
+	buildMenu(root, 1, BENCH_MENU_DEPTH, BENCH_MENU_FANOUT, m_menuNodes);
+	m_menu.setup(root, ofPoint(ofGetWidth() / 2, ofGetHeight()), 60);
+	root->setActive(true);
+
+	// Input
+	m_nNumEvents = 0;
+	m_nNumDropped = 0;
+	m_frameTimes.reserve(BENCH_NUM_FRAMES);
+	ofAddListener(m_handler.touchBatch, this, &ofApp::touchBatch);
+#if BENCH_USE_ROUTER
+	for (int i = 0; i < BENCH_NUM_STAINS; i++)
+	{
+		m_router.addTarget(&m_stains[i]);
+	}
+	for (int i = 0; i < BENCH_NUM_BUTTONS; i++)
+	{
+		m_router.addTarget(&m_buttons[i]);
+	}
+	m_router.addTarget(&m_menu);
+	ofAddListener(m_handler.touchBatch, &m_router, &ofxTactoTouchRouter::touchBatch);
+	m_handler.setLegacyEventsEnabled(false);
+#endif
+	m_source.setup(BENCH_NUM_CURSORS, BENCH_CURSOR_SPEED, BENCH_CHURN_RATE, BENCH_TRACKER_RATE);
+}
+
+void ofApp::update()
+{
+	unsigned long long start = ofGetElapsedTimeMicros();
+
+	// One tracker frame, as fast as possible
+	m_source.emitFrame(m_handler);
+	m_handler.update();
+	for (int i = 0; i < BENCH_NUM_STAINS; i++)
+	{
+		m_stains[i].update();
+	}
+	m_droppedNodes.clear();
+	m_nNumDropped += m_menu.drainDroppedNodes(m_droppedNodes);
+
+	m_frameTimes.push_back(ofGetElapsedTimeMicros() - start);
+	if (m_frameTimes.size() >= BENCH_NUM_FRAMES)
+	{
+		report();
+		benchmarkKernels();
+		checkKernels();
+		benchmarkMenuSetup();
+		checkMenuHitTests();
+		checkTrackerBuffers();
+		benchmarkLayouts();
+		benchmarkAliveReconciliation();
+		benchmarkReplay();
+		ofExit();
+	}
+}
+
+void ofApp::exit()
+{
+	ofRemoveListener(m_handler.touchBatch, this, &ofApp::touchBatch);
+#if BENCH_USE_ROUTER
+	ofRemoveListener(m_handler.touchBatch, &m_router, &ofxTactoTouchRouter::touchBatch);
+#endif
+	for (unsigned int i = 0; i < m_menuNodes.size(); i++)
+	{
+		delete m_menuNodes[i];
+	}
+	m_menuNodes.clear();
+}
+
+/** \note Only called when BENCH_USE_ROUTER is 0.
+* \param _touch The touch event, in [0;1] coordinates.
+*/
+void ofApp::touchDown(ofTouchEventArgs& _touch)
+{
+	for (int i = 0; i < BENCH_NUM_STAINS; i++)
+	{
+		m_stains[i].touchDown(_touch.x, _touch.y, _touch.id);
+	}
+	for (int i = 0; i < BENCH_NUM_BUTTONS; i++)
+	{
+		if (m_buttons[i].isPointInside(_touch.x, _touch.y, false))
+			m_buttons[i].touchDown(_touch.x, _touch.y, _touch.id);
+	}
+	m_menu.touchDown(_touch.x, _touch.y, _touch.id);
+}
+
+/** \param _touch The touch event, in [0;1] coordinates.
+*/
+void ofApp::touchMoved(ofTouchEventArgs& _touch)
+{
+	for (int i = 0; i < BENCH_NUM_STAINS; i++)
+	{
+		m_stains[i].touchMoved(_touch.x, _touch.y, _touch.id);
+	}
+	m_menu.touchMoved(_touch.x, _touch.y, _touch.id);
+}
+
+/** \param _touch The touch event, in [0;1] coordinates.
+*/
+void ofApp::touchUp(ofTouchEventArgs& _touch)
+{
+	for (int i = 0; i < BENCH_NUM_STAINS; i++)
+	{
+		m_stains[i].touchUp(_touch.x, _touch.y, _touch.id);
+	}
+	m_menu.touchUp(_touch.x, _touch.y, _touch.id);
+}
+
+/** \param _args The touch changes of the frame.
+*/
+void ofApp::touchBatch(ofxTactoTouchBatchEventArgs& _args)
+{
+	m_nNumEvents += _args.numEvents;
+}
+
+/** \param _ptNode The node below which to build.
+* \param _nDepth The depth of the node's children.
+* \param _nMaxDepth The depth of the leaves.
+* \param _nFanout The number of children of each node.
+* \param _nodes Receives the created nodes, for deletion.
+*/
+void ofApp::buildMenu(ofxTactoSHPMNode* _ptNode, int _nDepth, int _nMaxDepth, int _nFanout, vector<ofxTactoSHPMNode*>& _nodes)
+{
+	for (int i = 0; i < _nFanout; i++)
+	{
+		ofxTactoSHPMNode* child;
+		if (_nDepth == _nMaxDepth)
+			child = new ofxTactoBeatNode(ofColor(0, 255, 0), "loop.wav", -1, (TACTO_LOOPTYPE)(1 + i % 3), 4);
+		else
+			child = new ofxTactoSHPMNode(ofColor(0, 0, 255));
+		_nodes.push_back(child);
+		_ptNode->addChild(child);
+		if (_nDepth < _nMaxDepth)
+			buildMenu(child, _nDepth + 1, _nMaxDepth, _nFanout, _nodes);
+	}
+}
+
+void ofApp::report()
+{
+	vector<unsigned long long> sorted = m_frameTimes;
+	std::sort(sorted.begin(), sorted.end());
+	unsigned long long total = 0;
+	for (unsigned int i = 0; i < sorted.size(); i++)
+	{
+		total += sorted[i];
+	}
+	int n = sorted.size();
+
+	cout << "ofxTactoSonixTools input benchmark" << endl;
+	cout << "  cursors: " << BENCH_NUM_CURSORS << ", stains: " << BENCH_NUM_STAINS
+		<< ", buttons: " << BENCH_NUM_BUTTONS << ", menu nodes: " << m_menuNodes.size() << endl;
+	cout << "  routing: " << (BENCH_USE_ROUTER ? "touch router" : "broadcast") << endl;
+	cout << "  stain size: " << sizeof(ofxTactoStain) << " bytes" << endl;
+	cout << "  frames: " << n << endl;
+	cout << "  frame time (us): p50 " << sorted[n / 2] << ", p95 " << sorted[n * 95 / 100]
+		<< ", p99 " << sorted[n * 99 / 100] << ", max " << sorted[n - 1] << endl;
+	cout << "  touch events: " << m_nNumEvents << " ("
+		<< (total > 0 ? m_nNumEvents * 1000000.0 / total : 0) << " per second of input processing)" << endl;
+	cout << "  menu nodes dropped: " << m_nNumDropped << " (" << m_menu.getNumAllocatedNodes() << " allocated for dragging)" << endl;
+}
+
+void ofApp::benchmarkKernels()
+{
+	// A stain-like polygon, padded as the kernels expect
+	float xs[BENCH_KERNEL_VERTICES], ys[BENCH_KERNEL_VERTICES], prevXs[BENCH_KERNEL_VERTICES], prevYs[BENCH_KERNEL_VERTICES];
+	for (int i = 0; i < BENCH_KERNEL_VERTICES; i++)
+	{
+		float angle = TWO_PI * i / BENCH_KERNEL_VERTICES;
+		float radius = 0.1f + 0.05f * sin(angle * 5);
+		xs[i] = radius * cos(angle);
+		ys[i] = radius * sin(angle);
+	}
+	for (int i = 0; i < BENCH_KERNEL_VERTICES; i++)
+	{
+		prevXs[i] = xs[i == 0 ? BENCH_KERNEL_VERTICES - 1 : i - 1];
+		prevYs[i] = ys[i == 0 ? BENCH_KERNEL_VERTICES - 1 : i - 1];
+	}
+	vector<float> pointXs(BENCH_KERNEL_QUERIES), pointYs(BENCH_KERNEL_QUERIES);
+	for (int i = 0; i < BENCH_KERNEL_QUERIES; i++)
+	{
+		pointXs[i] = ofRandom(-0.2f, 0.2f);
+		pointYs[i] = ofRandom(-0.2f, 0.2f);
+	}
+	bool* results = new bool[BENCH_KERNEL_QUERIES];
+	int nHits[4] = { 0, 0, 0, 0 };
+
+	unsigned long long start = ofGetElapsedTimeMicros();
+	for (int i = 0; i < BENCH_KERNEL_QUERIES; i++)
+	{
+		nHits[0] += TactoGeometry::pointInPolygonScalar(xs, ys, prevXs, prevYs, BENCH_KERNEL_VERTICES, pointXs[i], pointYs[i]);
+	}
+	unsigned long long scalarTime = ofGetElapsedTimeMicros() - start;
+
+	start = ofGetElapsedTimeMicros();
+	for (int i = 0; i < BENCH_KERNEL_QUERIES; i++)
+	{
+		nHits[1] += TactoGeometry::pointInPolygon(xs, ys, prevXs, prevYs, BENCH_KERNEL_VERTICES, pointXs[i], pointYs[i]);
+	}
+	unsigned long long simdTime = ofGetElapsedTimeMicros() - start;
+
+	start = ofGetElapsedTimeMicros();
+	TactoGeometry::pointsInPolygon(xs, ys, prevXs, prevYs, BENCH_KERNEL_VERTICES, &pointXs[0], &pointYs[0], BENCH_KERNEL_QUERIES, 0, 0, results);
+	unsigned long long batchTime = ofGetElapsedTimeMicros() - start;
+	for (int i = 0; i < BENCH_KERNEL_QUERIES; i++)
+	{
+		nHits[2] += results[i];
+	}
+	delete[] results;
+
+	start = ofGetElapsedTimeMicros();
+	for (int i = 0; i < BENCH_KERNEL_QUERIES; i++)
+	{
+		nHits[3] += TactoGeometry::firstVertexWithinScalar(xs, ys, BENCH_KERNEL_VERTICES, pointXs[i], pointYs[i], 0.0016f) >= 0;
+	}
+	unsigned long long proximityScalarTime = ofGetElapsedTimeMicros() - start;
+	start = ofGetElapsedTimeMicros();
+	for (int i = 0; i < BENCH_KERNEL_QUERIES; i++)
+	{
+		nHits[3] -= TactoGeometry::firstVertexWithin(xs, ys, BENCH_KERNEL_VERTICES, pointXs[i], pointYs[i], 0.0016f) >= 0;
+	}
+	unsigned long long proximitySimdTime = ofGetElapsedTimeMicros() - start;
+
+	cout << "hit-test kernels (" << BENCH_KERNEL_QUERIES << " points, " << BENCH_KERNEL_VERTICES << " vertices)" << endl;
+	cout << "  point in polygon (us): scalar " << scalarTime << ", simd " << simdTime << ", batched " << batchTime << endl;
+	cout << "  vertex proximity (us): scalar " << proximityScalarTime << ", simd " << proximitySimdTime << endl;
+	if (nHits[0] != nHits[1] || nHits[0] != nHits[2] || nHits[3] != 0)
+		cout << "  warning: the kernels disagree with their scalar versions" << endl;
+}
+
+/** \note Polygons of 3 to BENCH_KERNEL_CHECK_VERTICES vertices (so every count modulo 4) are laid out as the
+* stains lay them out, padded with NaN, and tested at random points, at their vertices and at the middle of
+* their edges. The kernels must give exactly the answers of the scalar functions.
+*/
+void ofApp::checkKernels()
+{
+	int nNumChecks = 0;
+	int nNumMismatches = 0;
+	for (int nVertices = 3; nVertices <= BENCH_KERNEL_CHECK_VERTICES; nVertices++)
+	{
+		int nPadded = TactoGeometry::paddedCount(nVertices);
+		vector<float> xs(nPadded, NAN), ys(nPadded, NAN), prevXs(nPadded, NAN), prevYs(nPadded, NAN);
+		for (int nPolygon = 0; nPolygon < BENCH_KERNEL_CHECK_POLYGONS; nPolygon++)
+		{
+			// Star-shaped polygons, and arbitrary (self-intersecting) ones
+			bool bStar = nPolygon % 2 == 0;
+			for (int i = 0; i < nVertices; i++)
+			{
+				float angle = TWO_PI * i / nVertices;
+				float radius = ofRandom(0.02f, 0.2f);
+				xs[i] = bStar ? radius * cos(angle) : ofRandom(-0.2f, 0.2f);
+				ys[i] = bStar ? radius * sin(angle) : ofRandom(-0.2f, 0.2f);
+			}
+			for (int i = 0; i < nVertices; i++)
+			{
+				prevXs[i] = xs[i == 0 ? nVertices - 1 : i - 1];
+				prevYs[i] = ys[i == 0 ? nVertices - 1 : i - 1];
+			}
+
+			vector<float> pointXs, pointYs;
+			for (int i = 0; i < nVertices; i++)
+			{
+				pointXs.push_back(xs[i]);
+				pointYs.push_back(ys[i]);
+				pointXs.push_back((xs[i] + prevXs[i]) / 2);
+				pointYs.push_back((ys[i] + prevYs[i]) / 2);
+			}
+			// An odd number of points, so that the batched kernel also goes through its scalar tail
+			for (int i = 0; i < 4 * nVertices + 1; i++)
+			{
+				pointXs.push_back(ofRandom(-0.25f, 0.25f));
+				pointYs.push_back(ofRandom(-0.25f, 0.25f));
+			}
+
+			int nPoints = pointXs.size();
+			float fOffsetX = ofRandom(-1, 1);
+			float fOffsetY = ofRandom(-1, 1);
+			vector<float> offsetXs(nPoints), offsetYs(nPoints);
+			for (int i = 0; i < nPoints; i++)
+			{
+				offsetXs[i] = pointXs[i] + fOffsetX;
+				offsetYs[i] = pointYs[i] + fOffsetY;
+			}
+			bool* results = new bool[nPoints];
+			TactoGeometry::pointsInPolygon(&xs[0], &ys[0], &prevXs[0], &prevYs[0], nVertices, &offsetXs[0], &offsetYs[0], nPoints, fOffsetX, fOffsetY, results);
+
+			for (int i = 0; i < nPoints; i++)
+			{
+				bool bInside = TactoGeometry::pointInPolygonScalar(&xs[0], &ys[0], &prevXs[0], &prevYs[0], nVertices, pointXs[i], pointYs[i]);
+				bool bBatchInside = TactoGeometry::pointInPolygonScalar(&xs[0], &ys[0], &prevXs[0], &prevYs[0], nVertices, offsetXs[i] - fOffsetX, offsetYs[i] - fOffsetY);
+				float fRadiusSq = ofRandom(0, 0.01f);
+				nNumMismatches += TactoGeometry::pointInPolygon(&xs[0], &ys[0], &prevXs[0], &prevYs[0], nVertices, pointXs[i], pointYs[i]) != bInside;
+				nNumMismatches += results[i] != bBatchInside;
+				nNumMismatches += TactoGeometry::firstVertexWithin(&xs[0], &ys[0], nVertices, pointXs[i], pointYs[i], fRadiusSq) !=
+					TactoGeometry::firstVertexWithinScalar(&xs[0], &ys[0], nVertices, pointXs[i], pointYs[i], fRadiusSq);
+				// The padding never hits, however large the radius
+				nNumMismatches += TactoGeometry::firstVertexWithin(&xs[0], &ys[0], nVertices, pointXs[i], pointYs[i], 1e30f) != 0;
+				nNumChecks += 4;
+			}
+			delete[] results;
+		}
+	}
+
+	cout << "hit-test kernels check (" << nNumChecks << " comparisons)" << endl;
+	if (nNumMismatches > 0)
+		cout << "  warning: the kernels disagree with their scalar versions " << nNumMismatches << " times" << endl;
+}
+
+/** \note The time per node should stay flat as the menus get deeper.
+*/
+void ofApp::benchmarkMenuSetup()
+{
+	cout << "menu setup (fanout " << BENCH_DEEP_MENU_FANOUT << ")" << endl;
+	for (int nDepth = 2; nDepth <= BENCH_DEEP_MENU_DEPTH; nDepth += 2)
+	{
+		vector<ofxTactoSHPMNode*> nodes;
+		ofxTactoSHPMNode* root = new ofxTactoSHPMNode(ofColor(128));
+		nodes.push_back(root);
+
+		unsigned long long start = ofGetElapsedTimeMicros();
+		buildMenu(root, 1, nDepth, BENCH_DEEP_MENU_FANOUT, nodes);
+		unsigned long long buildTime = ofGetElapsedTimeMicros() - start;
+		ofxTactoSHPM menu;
+		start = ofGetElapsedTimeMicros();
+		menu.setup(root, ofPoint(ofGetWidth() / 2, ofGetHeight()), 60);
+		unsigned long long setupTime = ofGetElapsedTimeMicros() - start;
+
+		cout << "  depth " << root->getHeight() << ", " << root->getSubtreeSize() << " nodes: build " << buildTime
+			<< " us, setup " << setupTime << " us (" << setupTime * 1000.0 / nodes.size() << " ns per node)" << endl;
+		for (unsigned int i = 0; i < nodes.size(); i++)
+		{
+			delete nodes[i];
+		}
+	}
+}
+
+/** \note The nodes of the menu are activated at random, several siblings included, and each touch goes down in
+* both modes from the same state: the nodes dragged and the nodes left active must be the same. The touches are
+* at integer pixel coordinates, which the rings of the default mode expect, and away from the ring borders.
+*/
+void ofApp::checkMenuHitTests()
+{
+	vector<ofxTactoSHPMNode*> nodes;
+	ofxTactoSHPMNode* root = new ofxTactoSHPMNode(ofColor(128));
+	nodes.push_back(root);
+	buildMenu(root, 1, BENCH_MENU_DEPTH, BENCH_MENU_FANOUT, nodes);
+	ofxTactoSHPM menu;
+	int nWidth = 60;
+	menu.setup(root, ofPoint(ofGetWidth() / 2, ofGetHeight()), nWidth);
+	ofPoint ptOrigin = root->getOrigin();
+
+	vector<bool> activeBefore(nodes.size()), activeAfter(nodes.size());
+	vector<ofxTactoBeatNode> droppedNodes;
+	int nNumMismatches = 0;
+	int nNumDragged = 0;
+	for (int nTest = 0; nTest < BENCH_HITTEST_CHECKS; nTest++)
+	{
+		for (unsigned int i = 0; i < nodes.size(); i++)
+		{
+			activeBefore[i] = ofRandom(1) < 0.5f;
+		}
+		float fAngle = ofRandom(PI);
+		float fRadius = ((int)ofRandom(BENCH_MENU_DEPTH + 2) + ofRandom(0.02f, 0.98f)) * nWidth;
+		int x = ptOrigin.x + fRadius * cos(fAngle);
+		int y = ptOrigin.y - fRadius * sin(fAngle);
+
+		bool bMismatch = false;
+		int nDragged[2];
+		for (int nMode = 0; nMode < 2; nMode++)
+		{
+			for (unsigned int i = 0; i < nodes.size(); i++)
+			{
+				nodes[i]->setActive(activeBefore[i]);
+			}
+			menu.setPolarHitTest(nMode == 1);
+			menu.mouseTouchDown(x, y, true, 0, nTest);
+			nDragged[nMode] = menu.getDraggedNodes()->size();
+			menu.mouseTouchUp(x, y, true, 0, nTest);
+			droppedNodes.clear();
+			menu.drainDroppedNodes(droppedNodes);
+			for (unsigned int i = 0; i < nodes.size(); i++)
+			{
+				if (nMode == 0)
+					activeAfter[i] = nodes[i]->isActive();
+				else if (activeAfter[i] != nodes[i]->isActive())
+					bMismatch = true;
+			}
+		}
+		nNumDragged += nDragged[0];
+		nNumMismatches += bMismatch || nDragged[0] != nDragged[1];
+	}
+
+	cout << "menu hit tests (" << BENCH_HITTEST_CHECKS << " touches, " << nNumDragged << " nodes dragged)" << endl;
+	if (nNumMismatches > 0)
+		cout << "  warning: the polar hit test disagrees with the default one on " << nNumMismatches << " touches" << endl;
+	for (unsigned int i = 0; i < nodes.size(); i++)
+	{
+		delete nodes[i];
+	}
+}
+
+/** \note The stream sends set records, then alive records, and never an fseq: the pending records must stay
+* within TUIO_MAX_PENDING_RECORDS, and the set records must still reach the table.
+*/
+void ofApp::checkTrackerBuffers()
+{
+	ofxTactoTuioTracker tracker;
+	ofxTactoTuioRecord record;
+	record.time = ofGetElapsedTimeMicros();
+	record.profile = TUIO_PROFILE_CURSOR;
+	record.classId = 0;
+	record.x = record.y = record.vx = record.vy = 0.5f;
+	record.width = record.height = record.accel = 0;
+	record.angle = record.rotationSpeed = 0;
+
+	int nMaxPending = 0;
+	int nNumApplied = 0;
+	int nNumRecords = 10 * TUIO_MAX_PENDING_RECORDS;
+	record.type = TUIO_RECORD_SET;
+	for (int i = 0; i < nNumRecords; i++)
+	{
+		record.id = i % 100;
+		nNumApplied += tracker.applyRecord(record);
+		nMaxPending = max(nMaxPending, tracker.getNumPendingRecords());
+	}
+	int nNumTracked = tracker.getTable().size();
+	record.type = TUIO_RECORD_ALIVE_BEGIN;
+	tracker.applyRecord(record);
+	record.type = TUIO_RECORD_ALIVE;
+	for (int i = 0; i < nNumRecords; i++)
+	{
+		record.id = i % 100;
+		tracker.applyRecord(record);
+		nMaxPending = max(nMaxPending, tracker.getNumPendingRecords());
+	}
+
+	cout << "unclosed tracker frames (" << nNumRecords << " set and alive records, no fseq)" << endl;
+	cout << "  frames applied: " << nNumApplied << ", most pending records: " << nMaxPending << endl;
+	if (nMaxPending > 2 * TUIO_MAX_PENDING_RECORDS || nNumApplied == 0 || nNumTracked != 100)
+		cout << "  warning: the pending frame of the tracker grew without limit" << endl;
+}
+
+/** \note Each query finds the cursor closest to a point, with the same branch-free loop over each layout:
+* the table sweeps its aligned coordinate arrays (\link ofxTactoBlobTable::closestSlot()), the arrays of
+* blobs stride over whole blobs, and the list (the former storage of the handler) chases pointers.
+*/
+void ofApp::benchmarkLayouts()
+{
+	vector<float> pointXs(BENCH_LAYOUT_QUERIES), pointYs(BENCH_LAYOUT_QUERIES);
+	for (int i = 0; i < BENCH_LAYOUT_QUERIES; i++)
+	{
+		pointXs[i] = ofRandom(1);
+		pointYs[i] = ofRandom(1);
+	}
+
+	cout << "cursor sweeps (" << BENCH_LAYOUT_QUERIES << " closest-cursor queries)" << endl;
+	for (int nCursors = 16; nCursors <= BENCH_LAYOUT_MAX_CURSORS; nCursors *= 4)
+	{
+		ofxTactoBlobTable table;
+		vector<ofxTactoBlob> blobVector;
+		list<ofxTactoBlob> blobList;
+		for (int i = 0; i < nCursors; i++)
+		{
+			ofxTactoBlob blob(i, ofRandom(1), ofRandom(1), 0, 0, 0, 0, 0);
+			table.insert(blob);
+			blobVector.push_back(blob);
+			blobList.push_back(blob);
+		}
+		long long idSums[3] = { 0, 0, 0 };
+
+		unsigned long long start = ofGetElapsedTimeMicros();
+		for (int i = 0; i < BENCH_LAYOUT_QUERIES; i++)
+		{
+			idSums[0] += table.ids()[table.closestSlot(pointXs[i], pointYs[i], 2)];
+		}
+		unsigned long long soaTime = ofGetElapsedTimeMicros() - start;
+
+		start = ofGetElapsedTimeMicros();
+		for (int i = 0; i < BENCH_LAYOUT_QUERIES; i++)
+		{
+			float bestDistSq = 4;
+			int bestId = -1;
+			for (unsigned int j = 0; j < blobVector.size(); j++)
+			{
+				float dx = blobVector[j].x - pointXs[i];
+				float dy = blobVector[j].y - pointYs[i];
+				float distSq = dx * dx + dy * dy;
+				bool closer = distSq < bestDistSq;
+				bestDistSq = closer ? distSq : bestDistSq;
+				bestId = closer ? blobVector[j].id : bestId;
+			}
+			idSums[1] += bestId;
+		}
+		unsigned long long aosTime = ofGetElapsedTimeMicros() - start;
+
+		start = ofGetElapsedTimeMicros();
+		for (int i = 0; i < BENCH_LAYOUT_QUERIES; i++)
+		{
+			float bestDistSq = 4;
+			int bestId = -1;
+			for (list<ofxTactoBlob>::iterator It = blobList.begin(); It != blobList.end(); ++It)
+			{
+				float dx = It->x - pointXs[i];
+				float dy = It->y - pointYs[i];
+				float distSq = dx * dx + dy * dy;
+				bool closer = distSq < bestDistSq;
+				bestDistSq = closer ? distSq : bestDistSq;
+				bestId = closer ? It->id : bestId;
+			}
+			idSums[2] += bestId;
+		}
+		unsigned long long listTime = ofGetElapsedTimeMicros() - start;
+
+		double nsPerCursor = 1000.0 / ((double)BENCH_LAYOUT_QUERIES * nCursors);
+		cout << "  " << nCursors << " cursors (ns per cursor): table " << soaTime * nsPerCursor << ", vector of blobs "
+			<< aosTime * nsPerCursor << ", list of blobs " << listTime * nsPerCursor << endl;
+		if (idSums[0] != idSums[1] || idSums[0] != idSums[2])
+			cout << "  warning: the layouts disagree on the closest cursors" << endl;
+	}
+}
+
+/** \note All the blobs stay alive, so each alive message is pure reconciliation, and the time per blob should
+* stay flat as the blobs get more numerous. The same messages go through the tracker (decoded into records,
+* then closed by an fseq) and through the reconciliation that the handler did before its blob table (see
+* legacyManageBlobs()), on a list of blobs.
+*/
+void ofApp::benchmarkAliveReconciliation()
+{
+	cout << "alive reconciliation (" << BENCH_ALIVE_FRAMES << " alive messages)" << endl;
+	for (int nBlobs = 16; nBlobs <= BENCH_ALIVE_MAX_BLOBS; nBlobs *= 4)
+	{
+		ofxTactoTuioTracker tracker;
+		list<ofxTactoBlob> legacyBlobs;
+		vector<int> alive;
+		ofxOscMessage aliveMessage;
+		aliveMessage.setAddress("/tuio/2Dcur");
+		aliveMessage.addStringArg("alive");
+		for (int i = 0; i < nBlobs; i++)
+		{
+			alive.push_back(i + 1);
+			aliveMessage.addIntArg(i + 1);
+			legacyBlobs.push_back(ofxTactoBlob(i + 1, 0.5f, 0.5f, 0, 0, 0, 0, 0));
+		}
+		vector<ofxOscMessage> fseqMessages(BENCH_ALIVE_FRAMES);
+		for (int i = 0; i < BENCH_ALIVE_FRAMES; i++)
+		{
+			fseqMessages[i].setAddress("/tuio/2Dcur");
+			fseqMessages[i].addStringArg("fseq");
+			fseqMessages[i].addIntArg(i + 2);
+		}
+		// Put the blobs down
+		feedAliveFrame(tracker, alive, true, 1);
+
+		vector<ofxTactoTuioRecord> records;
+		unsigned long long nNumEvents = 0;
+		unsigned long long start = ofGetElapsedTimeMicros();
+		for (int i = 0; i < BENCH_ALIVE_FRAMES; i++)
+		{
+			records.clear();
+			ofxTactoTuioReceiver::decode(aliveMessage, records, 0);
+			ofxTactoTuioReceiver::decode(fseqMessages[i], records, 0);
+			for (unsigned int j = 0; j < records.size(); j++)
+			{
+				if (tracker.applyRecord(records[j]))
+					nNumEvents += tracker.getFrameEvents().size();
+			}
+		}
+		unsigned long long trackerTime = ofGetElapsedTimeMicros() - start;
+
+		int nNumLegacyUps = 0;
+		start = ofGetElapsedTimeMicros();
+		for (int i = 0; i < BENCH_ALIVE_FRAMES; i++)
+		{
+			legacyManageBlobs(aliveMessage, legacyBlobs, nNumLegacyUps);
+		}
+		unsigned long long legacyTime = ofGetElapsedTimeMicros() - start;
+
+		double nsPerBlob = 1000.0 / ((double)BENCH_ALIVE_FRAMES * nBlobs);
+		cout << "  " << nBlobs << " blobs (ns per blob): tracker " << trackerTime * nsPerBlob
+			<< ", former handler " << legacyTime * nsPerBlob << endl;
+		if (nNumEvents != 0 || tracker.getTable().size() != nBlobs || nNumLegacyUps != 0 || (int)legacyBlobs.size() != nBlobs)
+			cout << "  warning: blobs were lost during the reconciliation" << endl;
+	}
+}
+
+/** \note This is ofxTactoHandler::ManageBlobs() as it was before the handler had a blob table, with the touch
+* up events counted instead of fired. It is kept as the reference of benchmarkAliveReconciliation().
+* \param m The alive message.
+* \param _blobs The list of blobs.
+* \param _nNumUps Incremented for each blob that is not alive any more.
+*/
+void ofApp::legacyManageBlobs(ofxOscMessage m, list<ofxTactoBlob>& _blobs, int& _nNumUps)
+{
+	int numArgs = m.getNumArgs();
+	int numAliveBlobs = numArgs - 1;
+
+	// Create vector of alive blobs
+	vector<int> aliveBlobIDs;
+	if (numAliveBlobs > 0) // only if there are blobs
+	{
+		for (int i=0; i<numAliveBlobs; i++)
+		{
+			int currAliveBlob = m.getArgAsInt32(i + 1);
+			aliveBlobIDs.push_back(currAliveBlob);
+		}
+
+		// Traverse list of maintained blobs and remove those that are not alive
+		list<ofxTactoBlob>::iterator it = _blobs.begin();
+		while (it != _blobs.end())
+		{
+			if (legacyIsBlobIDInVector((*it).id, aliveBlobIDs))
+			{
+				// Leave blob as is
+				++it;
+			}
+			else
+			{
+				// Remove blob
+				_nNumUps++;
+				_blobs.erase(it++);
+			}
+		}
+	}
+}
+
+/** \note This is ofxTactoHandler::IsBlobIDInVector() as it was before the blob table, vector copy included.
+* \param blobID The queried ID.
+* \param vectorIDs The IDs to search.
+* \return Whether or not the ID is in the vector.
+*/
+bool ofApp::legacyIsBlobIDInVector(int blobID, vector<int> vectorIDs)
+{
+	bool breturn = false;
+	vector<int>::const_iterator it;
+	for (it = vectorIDs.begin(); it != vectorIDs.end(); ++it)
+	{
+		if (*it == blobID)
+		{
+			breturn = true;
+			break;
+		}
+	}
+	return breturn;
+}
+
+/** \note For each number of cursors, the frames of the synthetic source are recorded to BENCH_REPLAY_RECORDING
+* (in the data folder), then replayed as fast as possible by an \link ofxTactoTuioPlayer into a fresh handler.
+* The handler stores its blobs in a table keyed by session ID, so the time per cursor should stay flat as the
+* cursors get more numerous (it grew linearly with the former list). No widget listens to the handler, so
+* only the input path is measured.
+*/
+void ofApp::benchmarkReplay()
+{
+	cout << "cursor replay (" << BENCH_REPLAY_FRAMES << " recorded frames, churn " << BENCH_CHURN_RATE << " per second)" << endl;
+	for (int nCursors = 10; nCursors <= BENCH_REPLAY_MAX_CURSORS; nCursors *= 2)
+	{
+		// Record the frames
+		ofxTactoTuioRecorder recorder;
+		if (!recorder.start(BENCH_REPLAY_RECORDING))
+		{
+			cout << "  warning: cannot write " << BENCH_REPLAY_RECORDING << endl;
+			return;
+		}
+		ofxTactoHandler recordingHandler;
+		recordingHandler.setLegacyEventsEnabled(false);
+		recordingHandler.setRecorder(&recorder);
+		ofxTactoSyntheticSource source;
+		source.setup(nCursors, BENCH_CURSOR_SPEED, BENCH_CHURN_RATE, BENCH_TRACKER_RATE);
+		for (int i = 0; i < BENCH_REPLAY_FRAMES; i++)
+		{
+			source.emitFrame(recordingHandler);
+		}
+		recordingHandler.setRecorder(NULL);
+		recorder.stop();
+
+		// Replay them
+		ofxTactoTuioPlayer player;
+		if (!player.load(BENCH_REPLAY_RECORDING))
+		{
+			cout << "  warning: cannot read " << BENCH_REPLAY_RECORDING << endl;
+			return;
+		}
+		player.setSpeed(0);
+		player.play();
+		ofxTactoHandler handler;
+		handler.setLegacyEventsEnabled(false);
+		unsigned long long start = ofGetElapsedTimeMicros();
+		int nFed = player.update(handler);
+		unsigned long long replayTime = ofGetElapsedTimeMicros() - start;
+
+		cout << "  " << nCursors << " cursors: " << replayTime / (double)BENCH_REPLAY_FRAMES << " us per frame ("
+			<< replayTime * 1000.0 / ((double)BENCH_REPLAY_FRAMES * nCursors) << " ns per cursor, " << nFed << " records)" << endl;
+		if (nFed != player.getNumRecords())
+			cout << "  warning: the recording was not replayed whole" << endl;
+	}
+}
+
+/** \param _tracker The tracker to feed.
+* \param _alive The session IDs of the alive cursors.
+* \param _bSet Whether or not the frame also sets the state of every cursor.
+* \param _nFseq The sequence number of the frame.
+*/
+void ofApp::feedAliveFrame(ofxTactoTuioTracker& _tracker, const vector<int>& _alive, bool _bSet, int _nFseq)
+{
+	ofxTactoTuioRecord record;
+	record.time = ofGetElapsedTimeMicros();
+	record.profile = TUIO_PROFILE_CURSOR;
+	record.classId = 0;
+	record.x = record.y = record.vx = record.vy = 0.5f;
+	record.width = record.height = record.accel = 0;
+	record.angle = record.rotationSpeed = 0;
+
+	record.type = TUIO_RECORD_ALIVE_BEGIN;
+	record.id = _alive.size();
+	_tracker.applyRecord(record);
+	record.type = TUIO_RECORD_ALIVE;
+	for (unsigned int i = 0; i < _alive.size(); i++)
+	{
+		record.id = _alive[i];
+		_tracker.applyRecord(record);
+	}
+	record.type = TUIO_RECORD_ALIVE_END;
+	record.id = _alive.size();
+	_tracker.applyRecord(record);
+
+	record.type = TUIO_RECORD_SET;
+	for (unsigned int i = 0; _bSet && i < _alive.size(); i++)
+	{
+		record.id = _alive[i];
+		_tracker.applyRecord(record);
+	}
+
+	record.type = TUIO_RECORD_FSEQ;
+	record.id = _nFseq;
+	_tracker.applyRecord(record);
+}
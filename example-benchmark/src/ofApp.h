@@ -0,0 +1,101 @@
+#ifndef _OF_APP_BENCHMARK
+#define _OF_APP_BENCHMARK
+
+/**
+ * \class ofApp
+ *
+ * \brief A headless benchmark of the input path of the addon.
+ *
+ * A synthetic source (\link ofxTactoSyntheticSource) feeds one TUIO frame per update to an
+ * \link ofxTactoHandler, whose touch events are dispatched to stains, a stacked half-pie menu
+ * and buttons, the way a TactoSonix application would: through an \link ofxTactoTouchRouter, or
+ * broadcast to every widget when BENCH_USE_ROUTER is 0. The time spent per frame is measured,
+ * and the latency percentiles and event throughput are printed after BENCH_NUM_FRAMES frames.
+ * Microbenchmarks of the kernels, the menus and the blob storage follow.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxTactoHandler.h"
+#include "ofxTactoSyntheticSource.h"
+#include "UI/ofxTactoStain.h"
+#include "UI/ofxTactoSHPM.h"
+#include "UI/ofxTactoBeatNode.h"
+#include "UI/ofxTactoButtonOnOff.h"
+#include "UI/ofxTactoTouchRouter.h"
+#include "ofxTactoGeometry.h"
+#include "ofxTactoBlobTable.h"
+#include "ofxTactoTuioTracker.h"
+#include "ofxTactoTuioReceiver.h"
+#include "ofxTactoTuioRecorder.h"
+#include "ofxTactoTuioPlayer.h"
+#include "ofxOsc.h"
+
+#define BENCH_NUM_FRAMES 5000 ///< The number of measured frames.
+#define BENCH_NUM_CURSORS 50 ///< The number of simultaneous cursors.
+#define BENCH_CURSOR_SPEED 0.5f ///< The speed of the cursors, in screen units per second.
+#define BENCH_CHURN_RATE 0.5f ///< The number of times per second each cursor is replaced.
+#define BENCH_TRACKER_RATE 200.0f ///< The simulated tracker frame rate.
+#define BENCH_NUM_STAINS 90 ///< The number of stains.
+#define BENCH_NUM_BUTTONS 9 ///< The number of buttons (with the menu, 100 widgets in total).
+#define BENCH_USE_ROUTER 1 ///< Whether touches are routed (1) or broadcast to every widget (0).
+#define BENCH_MENU_FANOUT 6 ///< The number of children of each menu node.
+#define BENCH_MENU_DEPTH 3 ///< The number of menu levels.
+#define BENCH_DEEP_MENU_FANOUT 2 ///< The number of children of each node of the deep menus.
+#define BENCH_DEEP_MENU_DEPTH 14 ///< The number of levels of the deepest generated menu.
+#define BENCH_KERNEL_VERTICES 64 ///< The number of vertices of the polygon of the kernel benchmark.
+#define BENCH_KERNEL_QUERIES 200000 ///< The number of points tested by the kernel benchmark.
+#define BENCH_KERNEL_CHECK_VERTICES 20 ///< The largest number of vertices of the polygons of the kernel check.
+#define BENCH_KERNEL_CHECK_POLYGONS 200 ///< The number of polygons of each vertex count of the kernel check.
+#define BENCH_HITTEST_CHECKS 20000 ///< The number of touches on which the two menu hit tests are compared.
+#define BENCH_LAYOUT_MAX_CURSORS 1024 ///< The largest number of cursors swept by the layout benchmark.
+#define BENCH_LAYOUT_QUERIES 20000 ///< The number of closest-cursor queries of the layout benchmark.
+#define BENCH_ALIVE_MAX_BLOBS 1024 ///< The largest number of blobs of the alive reconciliation benchmark.
+#define BENCH_ALIVE_FRAMES 200 ///< The number of alive messages reconciled per blob count.
+#define BENCH_REPLAY_MAX_CURSORS 640 ///< The largest number of cursors of the replay benchmark.
+#define BENCH_REPLAY_FRAMES 500 ///< The number of frames replayed per cursor count.
+#define BENCH_REPLAY_RECORDING "benchmark-replay.tuio" ///< The recording written and replayed by the replay benchmark, in the data folder.
+
+/// The benchmark application.
+class ofApp : public ofBaseApp
+{
+public:
+	void									setup(); ///< Regular OpenFrameworks function.
+	void									update(); ///< Regular OpenFrameworks function.
+	void									exit(); ///< Regular OpenFrameworks function.
+	void									touchDown(ofTouchEventArgs& _touch); ///< Regular OpenFrameworks function.
+	void									touchMoved(ofTouchEventArgs& _touch); ///< Regular OpenFrameworks function.
+	void									touchUp(ofTouchEventArgs& _touch); ///< Regular OpenFrameworks function.
+	void									touchBatch(ofxTactoTouchBatchEventArgs& _args); ///< Counts the touch changes of a frame.
+
+private:
+	void									buildMenu(ofxTactoSHPMNode* _ptNode, int _nDepth, int _nMaxDepth, int _nFanout, vector<ofxTactoSHPMNode*>& _nodes); ///< Builds a generated menu below a node.
+	void									report(); ///< Prints the results.
+	void									benchmarkKernels(); ///< Compares the hit-test kernels with their scalar versions.
+	void									checkKernels(); ///< Checks that the hit-test kernels give the answers of their scalar versions.
+	void									benchmarkMenuSetup(); ///< Measures the setup time of deeper and deeper menus.
+	void									checkMenuHitTests(); ///< Checks that the polar hit test of the menu agrees with the default one.
+	void									checkTrackerBuffers(); ///< Checks that a stream that never closes its frames does not grow the tracker.
+	void									benchmarkLayouts(); ///< Compares cursor sweeps over the structure-of-arrays blob table and arrays of blobs.
+	void									benchmarkAliveReconciliation(); ///< Measures the reconciliation of alive messages with more and more blobs.
+	void									benchmarkReplay(); ///< Measures the handler on recorded frames of more and more simultaneous cursors.
+	void									legacyManageBlobs(ofxOscMessage m, list<ofxTactoBlob>& _blobs, int& _nNumUps); ///< Reconciles an alive message the way the handler did before its blob table.
+	static bool								legacyIsBlobIDInVector(int blobID, vector<int> vectorIDs); ///< Returns true if and only if the ID is in the vector, as the handler did before its blob table.
+	void									feedAliveFrame(ofxTactoTuioTracker& _tracker, const vector<int>& _alive, bool _bSet, int _nFseq); ///< Feeds a cursor frame to a tracker.
+
+	ofxTactoHandler							m_handler; ///< The touch system.
+	ofxTactoSyntheticSource					m_source; ///< The synthetic cursors.
+	ofxTactoStain							m_stains[BENCH_NUM_STAINS]; ///< The stains.
+	ofxTactoButtonOnOff						m_buttons[BENCH_NUM_BUTTONS]; ///< The buttons.
+	ofxTactoSHPM							m_menu; ///< The stacked half-pie menu.
+	ofxTactoTouchRouter						m_router; ///< The router that dispatches the touches to the widgets.
+	vector<ofxTactoSHPMNode*>				m_menuNodes; ///< The nodes of the menu, for deletion.
+	vector<unsigned long long>				m_frameTimes; ///< The time spent on each frame, in microseconds.
+	unsigned long long						m_nNumEvents; ///< The number of touch changes dispatched.
+	vector<ofxTactoBeatNode>				m_droppedNodes; ///< The nodes dropped from the menu during a frame.
+	unsigned long long						m_nNumDropped; ///< The number of nodes dropped from the menu.
+};
+
+#endif
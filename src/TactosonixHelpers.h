@@ -17,6 +17,11 @@
 #define OFX_POT_NUMSEQUENCERSTEPS 16
 #define DRAG_THRESHOLD 0.8f
 #define RADIUS_LOOP_PCT 0.5f
+#define TACTO_SIMD_ALIGNMENT 32
+
+#include <cstdlib>
+#include <cstddef>
+#include <new>
 
 namespace TactoHelpers
 {
@@ -44,6 +49,37 @@ namespace TactoHelpers
 		return retStruct;
 	}
 
+	/** \brief An allocator that aligns its blocks for SIMD loads (see TACTO_SIMD_ALIGNMENT).
+	*
+	* Use it for the arrays that hot loops sweep over, e.g. vector<float, alignedAllocator<float> >.
+	*/
+	template <class T, size_t ALIGNMENT = TACTO_SIMD_ALIGNMENT>
+	struct alignedAllocator {
+		typedef T value_type;
+		template <class U> struct rebind { typedef alignedAllocator<U, ALIGNMENT> other; };
+
+		alignedAllocator() {}
+		template <class U> alignedAllocator(const alignedAllocator<U, ALIGNMENT>&) {}
+
+		T* allocate(size_t _n)
+		{
+			// Over-allocate, align, and remember the original block just before the aligned one
+			void* raw = malloc(_n * sizeof(T) + ALIGNMENT + sizeof(void*));
+			if (!raw)
+				throw std::bad_alloc();
+			size_t aligned = ((size_t)raw + sizeof(void*) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+			((void**)aligned)[-1] = raw;
+			return (T*)aligned;
+		}
+		void deallocate(T* _p, size_t)
+		{
+			if (_p)
+				free(((void**)_p)[-1]);
+		}
+		template <class U> bool operator==(const alignedAllocator<U, ALIGNMENT>&) const { return true; }
+		template <class U> bool operator!=(const alignedAllocator<U, ALIGNMENT>&) const { return false; }
+	};
+
 	/// Different types of musical loops.
 	enum TACTO_LOOPTYPE {
 		TACTO_LOOPTYPE_NONE, ///< No sound.
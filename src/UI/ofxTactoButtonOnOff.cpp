@@ -134,3 +134,26 @@ void ofxTactoButtonOnOff::touchDown(float x, float y, int touchId)
 {
 	m_bEnabled = !m_bEnabled;
 }
+
+/** \param _bounds The bounding box of the button.
+* \return Whether or not the button takes touches (it does when it is active).
+*/
+bool ofxTactoButtonOnOff::getTouchBounds(ofRectangle& _bounds)
+{
+	if (!m_bActive)
+		return false;
+	_bounds.x = (m_ptOrigin.x - m_fRadius) / ofGetWidth();
+	_bounds.y = (m_ptOrigin.y - m_fRadius) / ofGetHeight();
+	_bounds.width = 2 * m_fRadius / ofGetWidth();
+	_bounds.height = 2 * m_fRadius / ofGetHeight();
+	return true;
+}
+
+/** \param x The x coordinate of the touch, in [0;1].
+* \param y The y coordinate of the touch, in [0;1].
+* \return Whether or not the touch is within the button.
+*/
+bool ofxTactoButtonOnOff::hitTest(float x, float y)
+{
+	return isPointInside(x, y, false);
+}
@@ -15,9 +15,10 @@
  */
 
 #include "ofxTextSuite.h"
+#include "UI/ofxTactoTouchTarget.h"
 
 /// A class that implements an on/off button.
-class ofxTactoButtonOnOff : public ofBaseApp
+class ofxTactoButtonOnOff : public ofBaseApp, public ofxTactoTouchTarget
 {
 public:
 	void				setup(int _nColorOn, int _nColorOff); ///< Override of a regular OpenFrameworks function.
@@ -30,6 +31,8 @@ public:
 	bool				getState(); ///< Returns the state (pushed or not) of the button.
 	void				setPosition(float _x, float _y); ///< Sets the position of the button.
 	bool				isPointInside(float _x, float _y, bool fullRange); ///< Returns true if and only if the specified coordinates are within the button.
+	bool				getTouchBounds(ofRectangle& _bounds); ///< Gets the bounding box of the button, in [0;1] coordinates.
+	bool				hitTest(float x, float y); ///< Returns true if and only if the [0;1] coordinates are within the button.
 	bool				isActive(); ///< Returns true if and only if the button is active.
 	void				setActive(bool _bActive); ///< Makes the button active or not.
 
@@ -1,9 +1,26 @@
 #include "UI/ofxTactoSHPM.h"
+#include "ofxTactoLatencyMonitor.h"
 #include "TactosonixHelpers.h"
 #include "assert.h"
 
 using namespace TactoHelpers;
 
+ofxTactoSHPM::~ofxTactoSHPM()
+{
+	for (unsigned int i = 0; i < m_draggedNodes.size(); i++)
+	{
+		delete m_draggedNodes[i];
+	}
+	for (unsigned int i = 0; i < m_droppedNodes.size(); i++)
+	{
+		delete m_droppedNodes[i];
+	}
+	for (unsigned int i = 0; i < m_freeNodes.size(); i++)
+	{
+		delete m_freeNodes[i];
+	}
+}
+
 /**
 * \param _rootNode The root node of the menu.
 * \param _ptCentre The origin of the menu.
@@ -19,68 +36,269 @@ void ofxTactoSHPM::setup(ofxTactoSHPMNode* _rootNode, ofPoint _ptCentre, int _nW
 	reset();
 }
 
-/** \brief This is a recursive function.
-* \param _ptNode The node at which to start the deactivation.
+/** \brief Flattens the menu tree into m_nodes, level by level, so that the children of a node are
+* contiguous and every node comes after its parent.
 */
-void ofxTactoSHPM::deactivateNodes(ofxTactoSHPMNode* _ptNode)
+void ofxTactoSHPM::compileNodes()
 {
-	if (_ptNode->getChildren().size() == 0)
+	m_nodes.clear();
+	if (!m_menuRoot)
 		return;
-	else
+
+	m_nodes.reserve(m_menuRoot->getSubtreeSize());
+	ofxTactoSHPMFlatNode root;
+	root.node = m_menuRoot;
+	root.parent = -1;
+	root.firstChild = 0;
+	root.numChildren = 0;
+	root.depth = 0;
+	m_nodes.push_back(root);
+	for (unsigned int i = 0; i < m_nodes.size(); i++)
 	{
-		_ptNode->setActive(false);
-		// The current node is active, let's handle its children
-		vector<ofxTactoSHPMNode*>::iterator It;
-		vector<ofxTactoSHPMNode*> children = _ptNode->getChildren();
-		for (It = children.begin(); It != children.end(); ++It)
+		const vector<ofxTactoSHPMNode*>& children = m_nodes[i].node->getChildren();
+		m_nodes[i].firstChild = m_nodes.size();
+		m_nodes[i].numChildren = children.size();
+		for (unsigned int j = 0; j < children.size(); j++)
 		{
-			deactivateNodes(*It);
+			ofxTactoSHPMFlatNode child;
+			child.node = children[j];
+			child.parent = i;
+			child.firstChild = 0;
+			child.numChildren = 0;
+			child.depth = m_nodes[i].depth + 1;
+			m_nodes.push_back(child);
 		}
 	}
+	m_visible.resize(m_nodes.size());
 }
 
-/** \brief This is a recursive function.
-* \param _ptNode The node at which to start the drag motion.
-* \param _x The x coordinate of the motion.
+/** \note The subtree size of the root is maintained by ofxTactoSHPMNode::addChild(), so checking
+* costs nothing. Like before, the added nodes are placed on the next reset().
+*/
+void ofxTactoSHPM::updateNodes()
+{
+	if (m_menuRoot && m_menuRoot->getSubtreeSize() != (int)m_nodes.size())
+	{
+		compileNodes();
+		m_nMaxDepth = maxDepth(m_menuRoot);
+	}
+}
+
+/** \brief A node is visible when all of its ancestors are active.
+*/
+void ofxTactoSHPM::updateVisibility()
+{
+	for (unsigned int i = 0; i < m_nodes.size(); i++)
+	{
+		int parent = m_nodes[i].parent;
+		m_visible[i] = parent < 0 || (m_visible[parent] && m_nodes[parent].node->isActive());
+	}
+}
+
+/** \brief Deactivates all the nodes that have children.
+*/
+void ofxTactoSHPM::deactivateNodes()
+{
+	for (unsigned int i = 0; i < m_nodes.size(); i++)
+	{
+		if (m_nodes[i].numChildren > 0)
+			m_nodes[i].node->setActive(false);
+	}
+}
+
+/** \param _x The x coordinate of the motion.
 * \param _y The y coordinate of the motion.
+* \return The first active leaf node under the point, or NULL.
 */
-ofxTactoSHPMNode* ofxTactoSHPM::dragNodes(ofxTactoSHPMNode* _ptNode, int _x, int _y)
+ofxTactoSHPMNode* ofxTactoSHPM::dragNodes(int _x, int _y)
 {
 	// Point will always be in world coordinates
 	ofPoint ptCompare(_x, _y);
     ptCompare.x /= ofGetWidth();
     ptCompare.y /= ofGetHeight();
 
-	if (_ptNode->isPointInside(ptCompare) && _ptNode->isActive() && _ptNode->getChildren().size() == 0)
+	for (unsigned int i = 0; i < m_nodes.size(); i++)
 	{
 		// Return this node if the point dragged is inside,
 		// the node is a leaf node (it has no children),
 		// and it is active.
-		return _ptNode;
+		ofxTactoSHPMNode* node = m_nodes[i].node;
+		if (m_nodes[i].numChildren == 0 && node->isActive() && node->isPointInside(ptCompare))
+			return node;
 	}
-	else
+	return NULL;
+}
+
+/** \note In this mode, a touch is converted once to a radius and an angle around the origin of the menu: the
+* radius gives the ring (the depth), and the angle gives the slice of the node among its siblings, as laid out
+* by placeNodes(). Only the nodes of that slice are then polygon-tested, and the walk down to them follows the
+* active children of each level (see findNodeInRing()), so a lookup costs O(depth) whatever the size of the menu
+* when one path is open. It finds the same nodes as the default mode. The coordinates of touches are also honoured in [0;1], which the ring tests of the default mode ignore.
+* \param _bPolar Whether or not to use polar hit testing (off by default).
+*/
+void ofxTactoSHPM::setPolarHitTest(bool _bPolar)
+{
+	m_bPolarHitTest = _bPolar;
+}
+
+/** \return Whether or not polar hit testing is used (see setPolarHitTest()).
+*/
+bool ofxTactoSHPM::isPolarHitTest()
+{
+	return m_bPolarHitTest;
+}
+
+/** \param _x The x coordinate of the point.
+* \param _y The y coordinate of the point.
+* \param _fullRange Whether or not the coordinates of the point are in pixels (false means [0-1]).
+* \param _fRadius Receives the distance of the point to the origin of the menu, in pixels.
+* \param _fAngle Receives the angle of the point around the origin, in radians (0 to the right, PI/2 upwards).
+*/
+void ofxTactoSHPM::toPolar(float _x, float _y, bool _fullRange, float& _fRadius, float& _fAngle)
+{
+	if (!_fullRange)
+	{
+		_x *= ofGetWidth();
+		_y *= ofGetHeight();
+	}
+	float dx = _x - m_ptOrigin.x;
+	float dy = m_ptOrigin.y - _y;
+	_fRadius = sqrt(dx*dx + dy*dy);
+	_fAngle = atan2(dy, dx);
+}
+
+/** \brief The polar counterpart of getClickedNode(), with the same effects on the active nodes.
+* \note The ring of the touch is reached through the active nodes (see findNodeInRing()), so both methods find
+* the same node, even when several siblings are active.
+* \param _x The x coordinate of the point.
+* \param _y The y coordinate of the point.
+* \param _fullRange Whether or not the coordinates of the point are in pixels (false means [0-1]).
+* \return The node under the point, or 0.
+*/
+ofxTactoSHPMNode* ofxTactoSHPM::getClickedNodePolar(float _x, float _y, bool _fullRange)
+{
+	if (m_nodes.empty() || m_nWidth <= 0)
+		return 0;
+
+	float fRadius, fAngle;
+	toPolar(_x, _y, _fullRange, fRadius, fAngle);
+	ofPoint ptCompare(_x, _y);
+	if (_fullRange)
+	{
+		ptCompare.x /= ofGetWidth();
+		ptCompare.y /= ofGetHeight();
+	}
+	int nNode = findNodeInRing(0, (int)(fRadius / m_nWidth), fAngle, ptCompare);
+	if (nNode < 0)
+		return 0;
+	ofxTactoSHPMNode* clickedNode = m_nodes[nNode].node;
+
+	// The node was clicked: activate it, and deactivate the other children of its ancestors, the nodes of its
+	// path included, as getClickedNode() does. Only the active children need a visit.
+	clickedNode->setActive(true);
+	for (int i = m_nodes[nNode].parent; i >= 0; i = m_nodes[i].parent)
 	{
-		vector<ofxTactoSHPMNode*>::iterator It;
-		vector<ofxTactoSHPMNode*> children = _ptNode->getChildren();
-		for (It = children.begin(); It != children.end(); ++It)
+		const ofxTactoSHPMFlatNode& flatNode = m_nodes[i];
+		for (int j = findActiveChild(i); j >= 0; j = findActiveChild(i))
 		{
-			ofxTactoSHPMNode* draggedChildNode = dragNodes(*It, _x, _y);
-			if (draggedChildNode)
+			if (m_nodes[j].node == clickedNode)
 			{
-				return draggedChildNode;
+				if (flatNode.node->getNumActiveChildren() == 1)
+					break;
+				// Other children are active too: deactivate them one by one
+				for (int k = flatNode.firstChild; k < flatNode.firstChild + flatNode.numChildren; k++)
+				{
+					if (m_nodes[k].node != clickedNode)
+						m_nodes[k].node->setActive(false);
+				}
+				break;
 			}
+			m_nodes[j].node->setActive(false);
 		}
-		return NULL;
 	}
+	return clickedNode;
+}
+
+/** \note The nodes of a ring lie within it, so only the ring of the point is searched. As in getClickedNode(),
+* the active children are visited in order and the first node under the point wins; in the last level, only the
+* children whose angular extent covers the point are polygon-tested. With one active child per level, a lookup
+* costs O(depth).
+* \param _nNode The index of a node of the flattened menu, at most as deep as the ring.
+* \param _nRing The ring of the point, which is also the depth of the nodes it can touch.
+* \param _fAngle The angle of the point around the origin of the menu (see toPolar()).
+* \param _ptCompare The point, in [0;1] coordinates.
+* \return The index of the node under the point, or -1.
+*/
+int ofxTactoSHPM::findNodeInRing(int _nNode, int _nRing, float _fAngle, const ofPoint& _ptCompare)
+{
+	const ofxTactoSHPMFlatNode& flatNode = m_nodes[_nNode];
+	if (flatNode.depth == _nRing)
+		return flatNode.node->isPointInside(_ptCompare) ? _nNode : -1;
+	if (!flatNode.node->isActive() || flatNode.numChildren == 0)
+		return -1;
+
+	if (flatNode.depth == _nRing - 1)
+	{
+		// The children are laid out by placeNodes(), at the middle of the ring
+		float fSpacingRads = PI / (flatNode.numChildren + 1);
+		float fRingRadius = m_nWidth * _nRing + m_nWidth / 2;
+		float fNodeRadius = m_nodes[flatNode.firstChild].node->getRadius();
+		float fHalfWidthRads = asin(min(1.0f, fNodeRadius / fRingRadius)) + 0.001f;
+		int nFirst = max(0, (int)ceil((_fAngle - fHalfWidthRads) / fSpacingRads) - 1);
+		int nLast = min(flatNode.numChildren - 1, (int)floor((_fAngle + fHalfWidthRads) / fSpacingRads) - 1);
+		for (int i = flatNode.firstChild + nFirst; i <= flatNode.firstChild + nLast; i++)
+		{
+			if (m_nodes[i].node->isPointInside(_ptCompare))
+				return i;
+		}
+		return -1;
+	}
+
+	ofxTactoSHPMNode* ptActiveChild = flatNode.node->getActiveChild();
+	if (ptActiveChild)
+		return findNodeInRing(flatNode.firstChild + ptActiveChild->getSiblingIndex(), _nRing, _fAngle, _ptCompare);
+	if (flatNode.node->getNumActiveChildren() == 0)
+		return -1;
+	for (int i = flatNode.firstChild; i < flatNode.firstChild + flatNode.numChildren; i++)
+	{
+		if (!m_nodes[i].node->isActive())
+			continue;
+		int nFound = findNodeInRing(i, _nRing, _fAngle, _ptCompare);
+		if (nFound >= 0)
+			return nFound;
+	}
+	return -1;
+}
+
+/** \note When several children are active, they are scanned for the first one; otherwise the answer comes
+* from the count kept by the node (see ofxTactoSHPMNode::getActiveChild()).
+* \param _nNode The index of the node in the flattened menu.
+* \return The index of an active child of the node, or -1 if none is active.
+*/
+int ofxTactoSHPM::findActiveChild(int _nNode)
+{
+	const ofxTactoSHPMFlatNode& flatNode = m_nodes[_nNode];
+	if (flatNode.node->getNumActiveChildren() == 0)
+		return -1;
+	ofxTactoSHPMNode* ptActiveChild = flatNode.node->getActiveChild();
+	if (ptActiveChild)
+		return flatNode.firstChild + ptActiveChild->getSiblingIndex();
+
+	for (int i = flatNode.firstChild; i < flatNode.firstChild + flatNode.numChildren; i++)
+	{
+		if (m_nodes[i].node->isActive())
+			return i;
+	}
+	return -1;
 }
 
 /** \brief This is a recursive function.
-* \param _ptNode The node at which to start the deactivation.
+* \param _nNode The index of the node at which to start (see m_nodes).
 * \param _x The x coordinate of the motion.
 * \param _y The y coordinate of the motion.
 * \param _fullRange Whether or not the coordinates of the queried point are in pixels (false means [0-1]).
 */
-ofxTactoSHPMNode* ofxTactoSHPM::getClickedNode(ofxTactoSHPMNode* _ptNode, float _x, float _y, bool _fullRange)
+ofxTactoSHPMNode* ofxTactoSHPM::getClickedNode(int _nNode, float _x, float _y, bool _fullRange)
 {
 	ofPoint ptCompare(_x, _y);
     if (_fullRange)
@@ -89,215 +307,147 @@ ofxTactoSHPMNode* ofxTactoSHPM::getClickedNode(ofxTactoSHPMNode* _ptNode, float
         ptCompare.y /= ofGetHeight();
     }
 
-	if (_ptNode->isPointInside(ptCompare))
+	const ofxTactoSHPMFlatNode& flatNode = m_nodes[_nNode];
+	if (flatNode.node->isPointInside(ptCompare))
 	{
 		// The current node was clicked
-		_ptNode->setActive(true);
-		return _ptNode;
+		flatNode.node->setActive(true);
+		return flatNode.node;
 	}
-	else
+	else if (flatNode.node->isActive())
 	{
-		// The cursor is not over the current node
-		if (_ptNode->isActive())
+		// The current node is active, let's handle its children
+		ofxTactoSHPMNode* returnedNode = 0;
+		int nEnd = flatNode.firstChild + flatNode.numChildren;
+		for (int i = flatNode.firstChild; i < nEnd && !returnedNode; i++)
 		{
-			bool bActivatedAChild = false;
-			ofxTactoSHPMNode* returnedNode = 0;
-			// The current node is active, let's handle its children
-			vector<ofxTactoSHPMNode*>::iterator It;
-			vector<ofxTactoSHPMNode*> children = _ptNode->getChildren();
-			for (It = children.begin(); It != children.end(); ++It)
-			{
-				if (!bActivatedAChild)
-				{
-					// No child node has yet been activated
-					returnedNode = getClickedNode(*It, _x, _y, _fullRange);
-					if (returnedNode)
-					{
-						// This child node was activated, the other ones must be deactivated!
-						bActivatedAChild = true;
-					}
-				}
-			}
-			if (bActivatedAChild)
-			{
-				// We have activated a child node, so let's disable the other ones at the same level
-				for (It = children.begin(); It != children.end(); ++It)
-				{
-					if (*It != returnedNode)
-					{
-						(*It)->setActive(false);
-					}
-				}
-			}
-			return returnedNode;
+			returnedNode = getClickedNode(i, _x, _y, _fullRange);
 		}
-		else
+		if (returnedNode)
 		{
-			return 0;
+			// We have activated a child node, so let's disable the other ones at the same level
+			for (int i = flatNode.firstChild; i < nEnd; i++)
+			{
+				if (m_nodes[i].node != returnedNode)
+					m_nodes[i].node->setActive(false);
+			}
 		}
+		return returnedNode;
+	}
+	else
+	{
+		// The cursor is not over the current node
+		return 0;
 	}
 }
 
-/** \brief This is a recursive function.
-* \param _ptNode The node at which to start counting.
-* \param _currentDepth The depth of the menu level.
+/** \note A visible inactive node counts as its depth, and the root being active counts as one level.
 * \return The number of active levels of the menu.
 */
-int ofxTactoSHPM::countActiveMenuLevels(ofxTactoSHPMNode* _ptNode, int _currentDepth)
+int ofxTactoSHPM::countActiveMenuLevels()
 {
-	if (!_ptNode->isActive())
-	{
-		return _currentDepth;
-	}
-	else
-	{
-		// If the current node is active and has children, we draw the level
-		vector<ofxTactoSHPMNode*>::iterator It;
-		vector<ofxTactoSHPMNode*> children = _ptNode->getChildren();
-		int nSubCount = 1;
+	if (m_nodes.empty() || !m_menuRoot->isActive())
+		return 0;
 
-		for (It = children.begin(); It != children.end(); ++It)
-		{
-			ofxTactoSHPMNode* currentNode = *It;
-			int nChildCount = countActiveMenuLevels(currentNode, _currentDepth + 1);
-			nSubCount = max (nSubCount, nChildCount);
-		}
+	return max(1, countActiveLevels(m_menuRoot, 0));
+}
 
-		return nSubCount;
+/** \note Only the active nodes are visited: a level is shown below a node as soon as one of its children is
+* inactive, and the active children lead further down. With one active path, the walk costs O(depth).
+* \param _ptNode An active node.
+* \param _nDepth The depth of the node.
+* \return The depth of the deepest inactive node shown in the subtree of the node, or 0 if there is none.
+*/
+int ofxTactoSHPM::countActiveLevels(ofxTactoSHPMNode* _ptNode, int _nDepth)
+{
+	const vector<ofxTactoSHPMNode*>& children = _ptNode->getChildren();
+	int nNumActive = _ptNode->getNumActiveChildren();
+	int nCount = nNumActive < (int)children.size() ? _nDepth + 1 : 0;
+	if (nNumActive == 0)
+		return nCount;
+
+	ofxTactoSHPMNode* ptActiveChild = _ptNode->getActiveChild();
+	if (ptActiveChild)
+		return max(nCount, countActiveLevels(ptActiveChild, _nDepth + 1));
+
+	for (unsigned int i = 0; i < children.size(); i++)
+	{
+		if (children[i]->isActive())
+			nCount = max(nCount, countActiveLevels(children[i], _nDepth + 1));
 	}
+	return nCount;
 }
 
-/** \brief This is a recursive function.
-* \param _ptNode The node at which to start drawing.
-* \param _currentDepth The depth of the menu level.
+/** \brief Draws a disc for each visible, active node that has children.
 */
-void ofxTactoSHPM::drawNodeLevels(ofxTactoSHPMNode* _ptNode, int _currentDepth)
+void ofxTactoSHPM::drawNodeLevels()
 {
-	if (_ptNode->isActive() && _ptNode->getChildren().size() != 0)
+	updateVisibility();
+	// Linear values for alpha gradient
+	int alpha = 255 / max(m_nMaxDepth, 1);
+	ofSetColor(m_menuRoot->getColor(), alpha);
+	for (unsigned int i = 0; i < m_nodes.size(); i++)
 	{
-		// If the current node is active and has children, we draw the level
-		vector<ofxTactoSHPMNode*>::iterator It;
-		vector<ofxTactoSHPMNode*> children = _ptNode->getChildren();
-		// Linear values for alpha gradient
-		int alpha = 255 / m_nMaxDepth;
-		ofSetColor(m_menuRoot->getColor(), alpha);
+		const ofxTactoSHPMFlatNode& flatNode = m_nodes[i];
 		// Draw donut before drawing nodes
-		ofCircle(m_ptOrigin, m_nWidth*(_currentDepth+1));
-
-		for (It = children.begin(); It != children.end(); ++It)
-		{
-			ofxTactoSHPMNode* currentNode = *It;
-			drawNodeLevels(currentNode, _currentDepth + 1);
-		}
+		if (m_visible[i] && flatNode.numChildren > 0 && flatNode.node->isActive())
+			ofCircle(m_ptOrigin, m_nWidth*(flatNode.depth + 2));
 	}
 }
 
-/** \brief This is a recursive function.
-* \param _ptNode The node at which to start drawing.
-* \param _currentDepth The depth of the menu level.
+/** \brief Draws the visible nodes, parents before their children.
 */
-void ofxTactoSHPM::drawNodes(ofxTactoSHPMNode* _ptNode, int _currentDepth)
+void ofxTactoSHPM::drawNodes()
 {
-	if (_ptNode->getChildren().size() == 0)
+	updateVisibility();
+	for (unsigned int i = 0; i < m_nodes.size(); i++)
 	{
-		// This is a child node
-		_ptNode->draw();
-		return;
-	}
-	else
-	{
-		if (_ptNode->isActive())
-		{
-			// If the current node is active, we draw its children
-			vector<ofxTactoSHPMNode*>::iterator It;
-			vector<ofxTactoSHPMNode*> children = _ptNode->getChildren();
-			// Linear values for alpha gradient
-			int alpha = 255 / m_nMaxDepth;
-			ofSetColor(m_menuRoot->getColor(), alpha);
-			_ptNode->draw();
-
-			for (It = children.begin(); It != children.end(); ++It)
-			{
-				ofxTactoSHPMNode* currentNode = *It;
-				drawNodes(currentNode, _currentDepth + 1);
-			}
-		}
-		else
-		{
-			// Otherwise we draw the node itself
-			_ptNode->draw();
-		}
+		if (m_visible[i])
+			m_nodes[i].node->draw();
 	}
 }
 
-/** \brief This method traverses the node's children and places them based on their depth and
- * the number of children at each level.
-* \param _ptNode The root node of the menu.
-* \param _currentDepth The depth of the menu level.
+/** \brief This method places each node based on its depth and the number of children of its parent.
 */
-void ofxTactoSHPM::placeNodes(ofxTactoSHPMNode* _ptNode, int _currentDepth)
+void ofxTactoSHPM::placeNodes()
 {
-	if (_ptNode->getChildren().size() == 0)
-		return;
-	else
+	for (unsigned int i = 0; i < m_nodes.size(); i++)
 	{
-		vector<ofxTactoSHPMNode*>::iterator It;
-		vector<ofxTactoSHPMNode*> children = _ptNode->getChildren();
-		int nNumChildren = children.size();
-		float fSpacingRads = PI / (nNumChildren + 2 - 1);
-		int nCount = 0;
-		for (It = children.begin(); It != children.end(); ++It)
+		const ofxTactoSHPMFlatNode& flatNode = m_nodes[i];
+		float fSpacingRads = PI / (flatNode.numChildren + 2 - 1);
+		for (int nCount = 0; nCount < flatNode.numChildren; nCount++)
 		{
-			ofxTactoSHPMNode* currentNode = *It;
+			ofxTactoSHPMNode* currentNode = m_nodes[flatNode.firstChild + nCount].node;
 
-			cartesianCoords relCoords = polToCar(m_nWidth*_currentDepth + m_nWidth/2,
+			cartesianCoords relCoords = polToCar(m_nWidth*(flatNode.depth + 1) + m_nWidth/2,
 				fSpacingRads * (nCount + 1));
 			cartesianCoords absCoords;
 			absCoords.x = m_ptOrigin.x + relCoords.x;
 			absCoords.y = m_ptOrigin.y - relCoords.y;
 			currentNode->setOrigin(ofPoint(absCoords.x, absCoords.y), true);
 			currentNode->setRadius(m_nWidth * 0.4f);
-			nCount++;
-			placeNodes(currentNode, _currentDepth + 1);
 		}
 	}
 }
 
-/** \param _ptNode The root node of the menu.
+/** \note The depth is maintained by ofxTactoSHPMNode::addChild(), so this takes constant time.
+* \param _ptNode The root node of the menu.
 * \return The depth of the menu.
 */
 int	ofxTactoSHPM::maxDepth(ofxTactoSHPMNode* _ptNode)
 {
-	if (_ptNode->getChildren().size() == 0)
-		return 0;
-	else
-	{
-		vector<ofxTactoSHPMNode*>::iterator It;
-		vector<ofxTactoSHPMNode*> children = _ptNode->getChildren();
-		int nMaxDepth = 0;
-		ofxTactoSHPMNode* ptNodeToExplore = *children.begin();
-		// Figure out max depth at current level
-		for (It = children.begin(); It != children.end(); ++It)
-		{
-			ofxTactoSHPMNode* currentNode = *It;
-			int nCurrentDepth = maxDepth(currentNode);
-			if (nCurrentDepth > nMaxDepth)
-			{
-				nMaxDepth = nCurrentDepth;
-				ptNodeToExplore = currentNode;
-			}
-		}
-		return maxDepth(ptNodeToExplore) + 1;
-	}
+	return _ptNode->getHeight();
 }
 
 void ofxTactoSHPM::draw()
 {
+	ofxTactoLatencyMonitor::get().mark(TACTO_LATENCY_DRAW);
+	updateNodes();
 	ofFill();
 	// First, draw the parent nodes
-	drawNodeLevels(m_menuRoot, 1);
+	drawNodeLevels();
 	// Then, draw the children nodes
-	drawNodes(m_menuRoot, 1);
+	drawNodes();
 
 	// Draw the nodes being dragged
 	vector<ofxTactoBeatNode*>::iterator It;
@@ -332,63 +482,43 @@ bool ofxTactoSHPM::isPointInsideRing(int x, int y, int nDepth, bool fullRange)
 /**
 * \brief This is a recursive function.
 *
-* \param _ptNode The node to query.
+* \param _nNode The index of the node to query (see m_nodes).
 * \param _x The x coordinate of the queried point.
 * \param _y The y coordinate of the queried point.
 * \param _currentDepth The depth of the menu level.
 * \return Whether or not the queried point is within the menu's rings.
 */
-bool ofxTactoSHPM::isPointInsideMenuRings(ofxTactoSHPMNode* _ptNode, int _x, int _y, int _currentDepth)
+bool ofxTactoSHPM::isPointInsideMenuRings(int _nNode, int _x, int _y, int _currentDepth)
 {
 	// Point will always be in world coordinates
 	ofPoint ptCompare(_x, _y);
     ptCompare.x /= ofGetWidth();
     ptCompare.y /= ofGetHeight();
 
-	if (_ptNode->isPointInside(ptCompare))
+	const ofxTactoSHPMFlatNode& flatNode = m_nodes[_nNode];
+	if (flatNode.node->isPointInside(ptCompare))
 	{
 		// The current node was clicked
 		return true;
 	}
-	else
+	else if (flatNode.numChildren > 0)
 	{
-		// The cursor is not over the current node
-		if (_ptNode->getChildren().size() > 0)
+		// The current node is active, was the click on its level?
+		if (isPointInsideRing(_x, _y, _currentDepth, true))
+			return true;
+
+		for (int i = flatNode.firstChild; i < flatNode.firstChild + flatNode.numChildren; i++)
 		{
-			// The current node is active, was the click on its level?
-			if (isPointInsideRing(_x, _y, _currentDepth, true))
-			{
+			if (isPointInsideMenuRings(i, _x, _y, _currentDepth+1))
 				return true;
-			}
-			else
-			{
-				bool bInsideChildRing = false;
-				vector<ofxTactoSHPMNode*>::iterator It;
-				vector<ofxTactoSHPMNode*> children = _ptNode->getChildren();
-				for (It = children.begin(); It != children.end(); ++It)
-				{
-					// No child node has yet been activated
-					if (isPointInsideMenuRings(*It, _x, _y, _currentDepth+1))
-					{
-						// This child node was activated, the other ones must be deactivated!
-						bInsideChildRing = true;
-						if (bInsideChildRing)
-						{
-							break;
-						}
-					}
-					else
-					{
-						(*It)->setActive(false);
-					}
-				}
-				return bInsideChildRing;
-			}
-		}
-		else
-		{
-			return false;
+			m_nodes[i].node->setActive(false);
 		}
+		return false;
+	}
+	else
+	{
+		// The cursor is not over the current node
+		return false;
 	}
 }
 
@@ -398,9 +528,17 @@ bool ofxTactoSHPM::isPointInsideMenuRings(ofxTactoSHPMNode* _ptNode, int _x, int
 * \param fullRange Whether or not the coordinates of the queried point are in pixels (false means [0-1]).
 * \return Whether or not the queried point is within the menu's active levels.
 */
-bool ofxTactoSHPM::isPointInsideActiveMenu(int x, int y, bool fullRange)
+bool ofxTactoSHPM::isPointInsideActiveMenu(float x, float y, bool fullRange)
 {
-	int nNumActiveMenus = countActiveMenuLevels(m_menuRoot, 0);
+	int nNumActiveMenus = countActiveMenuLevels();
+
+	if (m_bPolarHitTest)
+	{
+		// One distance instead of one per ring
+		float fRadius, fAngle;
+		toPolar(x, y, fullRange, fRadius, fAngle);
+		return fRadius > 0 && fRadius < (nNumActiveMenus + 1) * m_nWidth;
+	}
 
 	for (int i=0; i<nNumActiveMenus + 1; i++)
 	{
@@ -430,6 +568,16 @@ void ofxTactoSHPM::mousePressed(int x, int y, int button)
 	mouseTouchDown(x, y, true, button);
 }
 
+/**
+* \param x The x coordinate of the point.
+* \param y The y coordinate of the point.
+* \param button The ID of the mouse button.
+*/
+void ofxTactoSHPM::mouseReleased(int x, int y, int button)
+{
+	mouseTouchUp(x, y, true, button);
+}
+
 /**
 * \param w The new width in pixels.
 * \param h The new height in pixels.
@@ -460,6 +608,38 @@ void ofxTactoSHPM::touchMoved(float x, float y, int touchId)
 	mouseTouchMoved(x, y, false, 0, touchId);
 }
 
+/**
+* \param x The x coordinate of the touch event.
+* \param y The y coordinate of the touch event.
+* \param x The ID of the touch point.
+*/
+void ofxTactoSHPM::touchUp(float x, float y, int touchId)
+{
+	mouseTouchUp(x, y, false, 0, touchId);
+}
+
+/** \note While the menu is open, it covers the whole screen, since a touch outside of it closes it.
+* \param _bounds The bounding box of the menu.
+* \return Whether or not the menu takes touches.
+*/
+bool ofxTactoSHPM::getTouchBounds(ofRectangle& _bounds)
+{
+	if (!m_menuRoot)
+		return false;
+	updateNodes();
+	if (m_menuRoot->isActive())
+	{
+		_bounds.set(0, 0, 1, 1);
+		return true;
+	}
+	float radius = m_nWidth * (m_nMaxDepth + 1);
+	_bounds.x = (m_ptOrigin.x - radius) / ofGetWidth();
+	_bounds.y = (m_ptOrigin.y - radius) / ofGetHeight();
+	_bounds.width = 2 * radius / ofGetWidth();
+	_bounds.height = 2 * radius / ofGetHeight();
+	return true;
+}
+
 /** \return The root node of the menu.
 */
 ofxTactoSHPMNode* ofxTactoSHPM::getRoot()
@@ -475,16 +655,73 @@ void ofxTactoSHPM::reset()
 	m_menuRoot->setOriginInit(ptCentre, true);
 	m_menuRoot->setRadius(m_nWidth);
 	// Update node positions
-	placeNodes(m_menuRoot, 1);
+	compileNodes();
+	placeNodes();
 }
 
-/** \return The vector of dragged nodes.
+/** \note The nodes are owned by the menu: they go back to its pool when dropped and drained.
+* \note A node leaves the vector when its touch goes up. Before, the vector also held every dropped
+* node; use drainDroppedNodes() to get them.
+* \return The vector of the nodes being dragged.
 */
 vector<ofxTactoBeatNode*>* ofxTactoSHPM::getDraggedNodes()
 {
 	return &m_draggedNodes;
 }
 
+/** \note Call it regularly (e.g. once per frame): the menu holds at most SHPM_MAX_DRAGGED_NODES nodes, and
+* the oldest dropped nodes are recycled for new drags when they are not drained.
+* \param _nodes Receives copies of the nodes dropped since the last call, oldest first.
+* \return The number of nodes appended to _nodes.
+*/
+int ofxTactoSHPM::drainDroppedNodes(vector<ofxTactoBeatNode>& _nodes)
+{
+	int nNumDropped = m_droppedNodes.size();
+	for (int i = 0; i < nNumDropped; i++)
+	{
+		_nodes.push_back(*m_droppedNodes[i]);
+		m_freeNodes.push_back(m_droppedNodes[i]);
+	}
+	m_droppedNodes.clear();
+	return nNumDropped;
+}
+
+/** \return The number of nodes the menu allocated for dragging, at most SHPM_MAX_DRAGGED_NODES.
+*/
+int ofxTactoSHPM::getNumAllocatedNodes()
+{
+	return m_nAllocatedNodes;
+}
+
+/** \return A node to drag, from the pool, or 0 if SHPM_MAX_DRAGGED_NODES nodes are being dragged.
+*/
+ofxTactoBeatNode* ofxTactoSHPM::acquireNode()
+{
+	ofxTactoBeatNode* node = 0;
+	if (!m_freeNodes.empty())
+	{
+		node = m_freeNodes.back();
+		m_freeNodes.pop_back();
+	}
+	else if (m_nAllocatedNodes < SHPM_MAX_DRAGGED_NODES)
+	{
+		node = new ofxTactoBeatNode();
+		m_nAllocatedNodes++;
+	}
+	else if (!m_droppedNodes.empty())
+	{
+		// Nobody drained the oldest dropped node: it is lost
+		node = m_droppedNodes.front();
+		m_droppedNodes.erase(m_droppedNodes.begin());
+		if (!m_bWarnedLostDrop)
+		{
+			ofLogWarning() << "ofxTactoSHPM: a dropped node was recycled before being drained; call drainDroppedNodes() every frame";
+			m_bWarnedLostDrop = true;
+		}
+	}
+	return node;
+}
+
 /**
 * \param x The x coordinate of the point.
 * \param y The y coordinate of the point.
@@ -494,22 +731,29 @@ vector<ofxTactoBeatNode*>* ofxTactoSHPM::getDraggedNodes()
 */
 bool ofxTactoSHPM::mouseTouchDown(float x, float y, bool fullRange, int button, int touchId)
 {
+	updateNodes();
     bool bTouchIsInsideMenu = isPointInsideActiveMenu(x, y, fullRange);
 
-	ofxTactoSHPMNode* clickedNode = getClickedNode(m_menuRoot, x, y, fullRange);
+	ofxTactoSHPMNode* clickedNode = m_bPolarHitTest ? getClickedNodePolar(x, y, fullRange) : getClickedNode(0, x, y, fullRange);
 	if (!clickedNode)
 	{
-		if (!isPointInsideActiveMenu(x, y, fullRange))
-			deactivateNodes(m_menuRoot);
+		// Nothing changed since the test above
+		if (!bTouchIsInsideMenu)
+			deactivateNodes();
 	}
 	else
 	{
 		if (clickedNode->getChildren().size() == 0)
 		{
-			// It is a child node
-			ofxTactoBeatNode* newDraggedNode = new ofxTactoBeatNode(*(ofxTactoBeatNode*)clickedNode);
-			newDraggedNode->setOrigin(ofPoint(x, y), fullRange);
-			m_draggedNodes.push_back(newDraggedNode);
+			// It is a child node: drag a copy of it, from the pool
+			ofxTactoBeatNode* newDraggedNode = acquireNode();
+			if (newDraggedNode)
+			{
+				*newDraggedNode = *(ofxTactoBeatNode*)clickedNode;
+				newDraggedNode->setOrigin(ofPoint(x, y), fullRange);
+				m_draggedNodes.push_back(newDraggedNode);
+				m_draggedTouchIds.push_back(touchId);
+			}
 		}
 	}
 
@@ -525,17 +769,47 @@ bool ofxTactoSHPM::mouseTouchDown(float x, float y, bool fullRange, int button,
 */
 bool ofxTactoSHPM::mouseTouchMoved(float x, float y, bool fullRange, int button, int touchId)
 {
+	ofxTactoLatencyMonitor::get().mark(TACTO_LATENCY_WIDGET);
+	updateNodes();
     bool bTouchIsInsideMenu = isPointInsideActiveMenu(x, y, fullRange);
 
     bool bMovedNode = false; // true if we move something
 
-	vector<ofxTactoBeatNode*>::iterator It;
-	for (It = m_draggedNodes.begin(); It != m_draggedNodes.end(); ++It)
+	// Move the node dragged by this touch
+	for (unsigned int i = 0; i < m_draggedNodes.size(); i++)
 	{
-		(*It)->setOrigin(ofPoint(x, y), fullRange);
-		bMovedNode = true;
-		break;
+		if (m_draggedTouchIds[i] == touchId)
+		{
+			m_draggedNodes[i]->setOrigin(ofPoint(x, y), fullRange);
+			bMovedNode = true;
+			break;
+		}
 	}
 
 	return bMovedNode | bTouchIsInsideMenu;
 }
+
+/** \note The node dragged by the touch, if any, is dropped where the touch went up (see drainDroppedNodes()).
+* From then on the menu no longer draws it.
+* \param x The x coordinate of the point.
+* \param y The y coordinate of the point.
+* \param fullRange Whether or not the coordinates of the queried point are in pixels (false means [0-1]).
+* \param button The ID of the mouse button, in the case of mouse input.
+* \param touchId The ID of the touch event, in the case of touch input.
+* \return Whether or not a node was dropped.
+*/
+bool ofxTactoSHPM::mouseTouchUp(float x, float y, bool fullRange, int button, int touchId)
+{
+	for (unsigned int i = 0; i < m_draggedNodes.size(); i++)
+	{
+		if (m_draggedTouchIds[i] == touchId)
+		{
+			m_draggedNodes[i]->setOrigin(ofPoint(x, y), fullRange);
+			m_droppedNodes.push_back(m_draggedNodes[i]);
+			m_draggedNodes.erase(m_draggedNodes.begin() + i);
+			m_draggedTouchIds.erase(m_draggedTouchIds.begin() + i);
+			return true;
+		}
+	}
+	return false;
+}
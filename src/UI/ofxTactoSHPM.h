@@ -8,6 +8,14 @@
  *
  * See http://dl.acm.org/citation.cfm?id=1731936 for the paper by Hesselmann, Floering, and Schmitt.
  *
+ * Nodes dragged out of the menu are drawn by the menu until they are dropped. Dropped nodes are no longer
+ * drawn: the application takes them with drainDroppedNodes() and draws them itself.
+ *
+ * \note Breaking change: the menu used to keep every node ever dragged in getDraggedNodes() and draw it
+ * forever, so that memory grew with each drag. Dropped nodes now leave getDraggedNodes() on touch up, and
+ * the menu recycles them. Applications that read getDraggedNodes() to find the dropped nodes must call
+ * drainDroppedNodes() once per frame instead, and keep and draw the copies it returns.
+ *
  * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
  *
  * \version 1.0
@@ -16,45 +24,88 @@
  *
  */
 
+#define SHPM_MAX_DRAGGED_NODES 32 ///< The largest number of dragged and dropped nodes a menu holds
+
 #include "ofMain.h"
 #include "UI/ofxTactoSHPMNode.h"
 #include "UI/ofxTactoBeatNode.h"
+#include "UI/ofxTactoTouchTarget.h"
+
+/// A class that holds a node of a menu flattened into an array (see \link ofxTactoSHPM).
+class ofxTactoSHPMFlatNode
+{
+public:
+	ofxTactoSHPMNode*						node; ///< The node
+	int										parent; ///< The index of the parent node, or -1 for the root
+	int										firstChild; ///< The index of the first child node (the children are contiguous)
+	int										numChildren; ///< The number of children nodes
+	int										depth; ///< The depth of the node, the root being at 0
+};
 
 /// A class that implements a Stacked Half-Pie Menu.
-class ofxTactoSHPM : public ofBaseApp
+class ofxTactoSHPM : public ofBaseApp, public ofxTactoTouchTarget
 {
 public:
+	ofxTactoSHPM() : m_menuRoot(0), m_nMaxDepth(0), m_nWidth(0), m_bPolarHitTest(false), m_nAllocatedNodes(0), m_bWarnedLostDrop(false) {} ///< Constructor
+	~ofxTactoSHPM(); ///< Destructor
 	void									setup(ofxTactoSHPMNode* _rootNode, ofPoint _ptCentre, int _nWidth); ///< Override of a regular OpenFrameworks function.
+	void									setPolarHitTest(bool _bPolar); ///< Finds touched nodes from the polar coordinates of touches instead of testing every node.
+	bool									isPolarHitTest(); ///< Returns true if and only if polar hit testing is used.
 	void									draw(); ///< Regular OpenFrameworks function.
 	bool									isPointInsideRing(int x, int y, int nDepth, bool fullRange); ///< Returns true if and only if the point is within the menu level.
-	bool									isPointInsideActiveMenu(int x, int y, bool fullRange); ///< Returns true if and only if the point is within the menu's active levels.
+	bool									isPointInsideActiveMenu(float x, float y, bool fullRange); ///< Returns true if and only if the point is within the menu's active levels.
 	void									mouseDragged(int x, int y, int button); ///< Regular OpenFrameworks function.
 	void									mousePressed(int x, int y, int button); ///< Regular OpenFrameworks function.
+	void									mouseReleased(int x, int y, int button); ///< Regular OpenFrameworks function.
 	void									windowResized(int w, int h); ///< Regular OpenFrameworks function.
 	void									touchDown(float x, float y, int touchId); ///< Regular OpenFrameworks function.
 	void									touchMoved(float x, float y, int touchId); ///< Regular OpenFrameworks function.
+	void									touchUp(float x, float y, int touchId); ///< Regular OpenFrameworks function.
+	bool									getTouchBounds(ofRectangle& _bounds); ///< Gets the bounding box of the menu, in [0;1] coordinates.
 	ofxTactoSHPMNode*						getRoot(); ///< Returns the root node of the Stacked Half-Pie Menu.
-	vector<ofxTactoBeatNode*>*				getDraggedNodes(); ///< Returns a vector of dragged nodes.
+	vector<ofxTactoBeatNode*>*				getDraggedNodes(); ///< Returns a vector of the nodes being dragged. Breaking change: dropped nodes are no longer in it (see drainDroppedNodes()).
+	int										drainDroppedNodes(vector<ofxTactoBeatNode>& _nodes); ///< Hands the dropped nodes to the caller and recycles them. Replaces reading dropped nodes from getDraggedNodes().
+	int										getNumAllocatedNodes(); ///< Returns the number of nodes allocated for dragging.
 	bool									mouseTouchDown(float x, float y, bool fullRange, int button = 0, int touchId = 0); ///< A handler function for mouse and touch down events.
 	bool									mouseTouchMoved(float x, float y, bool fullRange, int button = 0, int touchId = 0); ///< A handler function for mouse and touch moved events.
+	bool									mouseTouchUp(float x, float y, bool fullRange, int button = 0, int touchId = 0); ///< A handler function for mouse and touch up events.
 
 private:
 	ofxTactoSHPMNode*						m_menuRoot; ///< The root of the menu.
 	int										m_nMaxDepth; ///< The max depth of the menu.
 	ofPoint									m_ptOrigin; ///< The origin of the menu.
 	int										m_nWidth; ///< The width in pixels of each menu layer.
+	bool									m_bPolarHitTest; ///< Whether or not touches are located from their polar coordinates.
 	vector<ofxTactoBeatNode*>				m_draggedNodes; ///< The nodes being dragged.
+	vector<int>								m_draggedTouchIds; ///< For each dragged node, the ID of the touch dragging it.
+	vector<ofxTactoBeatNode*>				m_droppedNodes; ///< The nodes dropped since the last drain, oldest first.
+	vector<ofxTactoBeatNode*>				m_freeNodes; ///< The pooled nodes that are not in use.
+	int										m_nAllocatedNodes; ///< The number of nodes allocated for dragging.
+	bool									m_bWarnedLostDrop; ///< Whether or not the loss of an undrained dropped node was logged.
+	vector<ofxTactoSHPMFlatNode>			m_nodes; ///< The nodes of the menu, level by level (the root is at index 0).
+	vector<char>							m_visible; ///< For each node of m_nodes, whether or not all of its ancestors are active.
 	
-	void									deactivateNodes(ofxTactoSHPMNode* _ptNode); ///< Deactivates a node and its children nodes.
-	ofxTactoSHPMNode*						dragNodes(ofxTactoSHPMNode* _ptNode, int _x, int _y); ///< Drag the nodes.
-	ofxTactoSHPMNode*						getClickedNode(ofxTactoSHPMNode* _ptNode, float _x, float _y, bool _fullRange); ///< Get the node at the queried position.
-	int										countActiveMenuLevels(ofxTactoSHPMNode* _ptNode, int _currentDepth); ///< Returns the number of active levels of the menu.
-	void									drawNodeLevels(ofxTactoSHPMNode* _ptNode, int _currentDepth); ///< Draws the levels of the menu.
-	void									drawNodes(ofxTactoSHPMNode* _ptNode, int _currentDepth); ///< Draws the nodes of the menu.
-	void									placeNodes(ofxTactoSHPMNode* _ptNode, int _currentDepth); ///< Places the nodes of the menu during initialization.
+	void									compileNodes(); ///< Flattens the menu tree into m_nodes.
+	void									updateNodes(); ///< Flattens the menu tree again if nodes were added since it was last flattened.
+	void									updateVisibility(); ///< Recomputes m_visible.
+	void									deactivateNodes(); ///< Deactivates the nodes of the menu that have children.
+	ofxTactoSHPMNode*						dragNodes(int _x, int _y); ///< Drag the nodes.
+	ofxTactoSHPMNode*						getClickedNode(int _nNode, float _x, float _y, bool _fullRange); ///< Get the node at the queried position.
+	ofxTactoSHPMNode*						getClickedNodePolar(float _x, float _y, bool _fullRange); ///< Get the node at the queried position, from its polar coordinates.
+	void									toPolar(float _x, float _y, bool _fullRange, float& _fRadius, float& _fAngle); ///< Converts a point to polar coordinates around the origin of the menu.
+	int										countActiveMenuLevels(); ///< Returns the number of active levels of the menu.
+	int										countActiveLevels(ofxTactoSHPMNode* _ptNode, int _nDepth); ///< Returns the depth of the deepest level shown below an active node.
+	int										findActiveChild(int _nNode); ///< Returns the index of an active child of a flattened node.
+	int										findNodeInRing(int _nNode, int _nRing, float _fAngle, const ofPoint& _ptCompare); ///< Returns the index of the node under a point of a ring, below a flattened node.
+	void									drawNodeLevels(); ///< Draws the levels of the menu.
+	void									drawNodes(); ///< Draws the nodes of the menu.
+	void									placeNodes(); ///< Places the nodes of the menu during initialization.
 	static int								maxDepth(ofxTactoSHPMNode* _ptNode); ///< Static function that returns the depth of a menu.
-	bool									isPointInsideMenuRings(ofxTactoSHPMNode* _ptNode, int _x, int _y, int _currentDepth); ///< Returns true if and only if the queried point is inside the rings of the menu.
+	bool									isPointInsideMenuRings(int _nNode, int _x, int _y, int _currentDepth); ///< Returns true if and only if the queried point is inside the rings of the menu.
 	void									reset(); ///< Reconfigures the menu when something changes.
+	ofxTactoBeatNode*						acquireNode(); ///< Takes a node to drag from the pool.
+	ofxTactoSHPM(const ofxTactoSHPM&); ///< Not copyable: the menu owns its pooled nodes.
+	ofxTactoSHPM&							operator=(const ofxTactoSHPM&); ///< Not copyable: the menu owns its pooled nodes.
 };
 
 #endif
@@ -8,54 +8,137 @@ using namespace TactoHelpers;
 * \param _type The type of musical loop that the node represents.
 */
 ofxTactoSHPMNode::ofxTactoSHPMNode(ofColor _color, TACTO_LOOPTYPE _type) :
-m_nType(_type), m_bActive(false), m_nColor(_color), m_children(0), m_ptOrigin(ofPoint(0, 0)), m_nRadius(20)
+m_nType(_type), m_bActive(false), m_nColor(_color), m_children(0), m_ptParent(0), m_nHeight(0), m_nSubtreeSize(1),
+m_levelCounts(1, 1), m_nSiblingIndex(0), m_nNumActiveChildren(0), m_ptActiveChild(0), m_ptOrigin(ofPoint(0, 0)), m_nRadius(20)
 {
-	int numVertices = 0;
-	switch (m_nType)
+	m_ptShape = getShape(m_nType, m_nRadius);
+}
+
+/** \note Shapes are built on first use and never freed, so the pointers stay valid; a menu only uses a
+* handful of radii.
+* \param _type The type of the nodes (see TACTO_LOOPTYPE), which gives the number of vertices.
+* \param _nRadius The radius of the nodes, in pixels.
+* \return The shape.
+*/
+const ofxTactoSHPMShape* ofxTactoSHPMNode::getShape(TACTO_LOOPTYPE _type, int _nRadius)
+{
+	static std::map<std::pair<int, int>, ofxTactoSHPMShape> shapes;
+	std::pair<int, int> key(_type, _nRadius);
+	std::map<std::pair<int, int>, ofxTactoSHPMShape>::iterator It = shapes.find(key);
+	if (It != shapes.end())
+		return &It->second;
+
+	ofxTactoSHPMShape& shape = shapes[key];
+	shape.numVertices = 0;
+	switch (_type)
 	{
 		case TACTO_LOOPTYPE_DRUMS:
-			numVertices = 4;
+			shape.numVertices = 4;
 			break;
 		case TACTO_LOOPTYPE_BASS:
-			numVertices = 5;
+			shape.numVertices = 5;
 			break;
 		case TACTO_LOOPTYPE_LEAD:
-			numVertices = 6;
+			shape.numVertices = 6;
 			break;
 		default:
 			break;
 	}
-	
-	float fSpacingRads = TWO_PI / numVertices;
-	for (int i=0; i<numVertices; i++)
+
+	float fSpacingRads = TWO_PI / max(shape.numVertices, 1);
+	for (int i=0; i<shape.numVertices; i++)
 	{
-		cartesianCoords relCoords = polToCar(getRadius(), fSpacingRads * (i + 1));
-		ofPoint currVertexPos(relCoords.x, relCoords.y);
-		m_vertices.push_back(&currVertexPos);
+		cartesianCoords relCoords = polToCar(_nRadius, fSpacingRads * (i + 1));
+		shape.vertices[i].set(relCoords.x, relCoords.y);
 	}
+	return &shape;
 }
 
-/** \param _pChild The child node to add.
+/** \note The height, size and level counts of this node and of its ancestors are updated on the way up,
+* in time proportional to the depth of this node times the height of the child.
+* \param _pChild The child node to add. It must not have a parent yet.
 */
 void ofxTactoSHPMNode::addChild(ofxTactoSHPMNode* _pChild)
 {
+	assert(!_pChild->m_ptParent);
 	_pChild->setRadius(m_nRadius);
+	_pChild->m_ptParent = this;
+	_pChild->m_nSiblingIndex = m_children.size();
 	m_children.push_back(_pChild);
+	if (_pChild->m_bActive)
+	{
+		m_nNumActiveChildren++;
+		m_ptActiveChild = m_nNumActiveChildren == 1 ? _pChild : 0;
+	}
+
+	const vector<int>& childLevels = _pChild->m_levelCounts;
+	int nDistance = 1;
+	for (ofxTactoSHPMNode* ptNode = this; ptNode; ptNode = ptNode->m_ptParent, nDistance++)
+	{
+		ptNode->m_nSubtreeSize += _pChild->m_nSubtreeSize;
+		ptNode->m_nHeight = max(ptNode->m_nHeight, _pChild->m_nHeight + nDistance);
+		if (ptNode->m_levelCounts.size() < childLevels.size() + nDistance)
+			ptNode->m_levelCounts.resize(childLevels.size() + nDistance, 0);
+		for (unsigned int i = 0; i < childLevels.size(); i++)
+		{
+			ptNode->m_levelCounts[i + nDistance] += childLevels[i];
+		}
+	}
 }
 
-/** \return The vector of children nodes.
+/** \return The depth of the node in its menu, the root being at 0.
 */
-vector<ofxTactoSHPMNode*> ofxTactoSHPMNode::getChildren()
+int ofxTactoSHPMNode::getDepth()
+{
+	int nDepth = 0;
+	for (ofxTactoSHPMNode* ptNode = m_ptParent; ptNode; ptNode = ptNode->m_ptParent)
+	{
+		nDepth++;
+	}
+	return nDepth;
+}
+
+/** \note The vector is returned by reference: it changes when children are added.
+* \return The vector of children nodes.
+*/
+const vector<ofxTactoSHPMNode*>& ofxTactoSHPMNode::getChildren()
 {
 	return m_children;
 }
 
-/**
+/** \note The parent keeps count of its active children, so that the active part of a menu can be walked
+* without visiting the inactive nodes. Copies of a node (the nodes dragged out of a menu) keep the parent
+* link of the original, but they are not among its children, so they leave the count alone.
 * \param _active Whether or not the node is active (deployed).
 */
 void ofxTactoSHPMNode::setActive(bool _active)
 {
+	if (_active == m_bActive)
+		return;
 	m_bActive = _active;
+	if (!m_ptParent || m_ptParent->m_children[m_nSiblingIndex] != this)
+		return;
+
+	ofxTactoSHPMNode* ptParent = m_ptParent;
+	ptParent->m_nNumActiveChildren += _active ? 1 : -1;
+	if (ptParent->m_nNumActiveChildren != 1)
+	{
+		ptParent->m_ptActiveChild = 0;
+	}
+	else if (_active)
+	{
+		ptParent->m_ptActiveChild = this;
+	}
+	else
+	{
+		// One active child is left: find it
+		ptParent->m_ptActiveChild = 0;
+		for (unsigned int i = 0; i < ptParent->m_children.size() && !ptParent->m_ptActiveChild; i++)
+		{
+			if (ptParent->m_children[i]->m_bActive)
+				ptParent->m_ptActiveChild = ptParent->m_children[i];
+		}
+	}
 }
 
 /**
@@ -90,10 +173,11 @@ bool ofxTactoSHPMNode::isPointInside(ofPoint pt)
 	{
 		int i, j;
 		// Vertices
-		for (i = 0, j = m_vertices.size()-1; i < m_vertices.size(); j = i++) {
-			if ((((m_ptOrigin.y + m_vertices[i]->y <= pt.y) && (pt.y < m_ptOrigin.y + m_vertices[j]->y)) ||
-				((m_ptOrigin.y + m_vertices[j]->y <= pt.y) && (pt.y < m_ptOrigin.y + m_vertices[i]->y))) &&
-				(pt.x < (m_vertices[j]->x - m_vertices[i]->x) * (pt.y - m_ptOrigin.y - m_vertices[i]->y) / (m_vertices[j]->y - m_vertices[i]->y) + m_ptOrigin.x + m_vertices[i]->x))
+		const ofPoint* vertices = m_ptShape->vertices;
+		for (i = 0, j = m_ptShape->numVertices-1; i < m_ptShape->numVertices; j = i++) {
+			if ((((m_ptOrigin.y + vertices[i].y <= pt.y) && (pt.y < m_ptOrigin.y + vertices[j].y)) ||
+				((m_ptOrigin.y + vertices[j].y <= pt.y) && (pt.y < m_ptOrigin.y + vertices[i].y))) &&
+				(pt.x < (vertices[j].x - vertices[i].x) * (pt.y - m_ptOrigin.y - vertices[i].y) / (vertices[j].y - vertices[i].y) + m_ptOrigin.x + vertices[i].x))
 				returnValue = !returnValue;
 		}
 	}
@@ -116,12 +200,12 @@ void ofxTactoSHPMNode::draw()
 	}
 	else
 	{
-		if (m_vertices.size() > 0)
+		if (m_ptShape->numVertices > 0)
 		{
 			ofBeginShape();
-			for (int i=0; i<m_vertices.size(); i++)
+			for (int i=0; i<m_ptShape->numVertices; i++)
 			{
-				ofVertex(m_vertices[i]->x + getOrigin().x, m_vertices[i]->y + getOrigin().y);
+				ofVertex(m_ptShape->vertices[i].x + m_ptOrigin.x, m_ptShape->vertices[i].y + m_ptOrigin.y);
 			}
 			ofEndShape();
 		}
@@ -136,7 +220,7 @@ ofPoint ofxTactoSHPMNode::getOrigin()
 	return m_ptOrigin;
 }
 
-/**
+/** \note Only the origin changes: the vertices are relative to it.
 * \param _origin The point of origin of the node.
 * \param fullRange Whether or not the coordinates of the queried point are in pixels (false means [0-1]).
 */
@@ -150,17 +234,6 @@ void ofxTactoSHPMNode::setOrigin(ofPoint _origin, bool fullRange)
 	{
 		m_ptOrigin = ofPoint(_origin.x * ofGetWidth(), _origin.y * ofGetHeight());
 	}
-	
-	// Refresh the vertices
-	int numVertices = m_vertices.size();
-	m_vertices.clear();
-	float fSpacingRads = TWO_PI / numVertices;
-	for (int i=0; i<numVertices; i++)
-	{
-		cartesianCoords relCoords = polToCar(getRadius(), fSpacingRads * (i + 1));
-		ofPoint* currVertexPos = new ofPoint(relCoords.x, relCoords.y);
-		m_vertices.push_back(currVertexPos);
-	}
 }
 
 /**
@@ -177,6 +250,7 @@ int ofxTactoSHPMNode::getRadius()
 void ofxTactoSHPMNode::setRadius(int _nRadius)
 {
 	m_nRadius = _nRadius;
+	m_ptShape = getShape(m_nType, m_nRadius);
 }
 
 /**
@@ -14,21 +14,40 @@
  *
  */
 
+#define SHPMNODE_MAX_VERTICES 6 ///< The largest number of vertices of a node shape
+
 #include "ofMain.h"
 #include "TactosonixHelpers.h"
 using namespace TactoHelpers;
 
+/// A class that holds the polygon of a node, relative to its origin. Nodes of the same type and radius share one.
+class ofxTactoSHPMShape
+{
+public:
+	int										numVertices; ///< The number of vertices (0 for a circle)
+	ofPoint									vertices[SHPMNODE_MAX_VERTICES]; ///< The vertex coordinates, relative to the origin
+};
+
 /// A class that implements nodes in a Stacked Half-Pie Menu.
 class ofxTactoSHPMNode : public ofBaseApp
 {
 public:
 	ofxTactoSHPMNode(ofColor _color, TACTO_LOOPTYPE _type = TACTO_LOOPTYPE_NONE); ///< Constructor
 	ofxTactoSHPMNode() :
-		m_nColor(0), m_bActive(false), m_nType(TACTO_LOOPTYPE_DRUMS) {}; ///< Default constructor
+		m_nColor(0), m_bActive(false), m_nType(TACTO_LOOPTYPE_DRUMS), m_ptParent(0), m_nHeight(0), m_nSubtreeSize(1), m_levelCounts(1, 1),
+		m_nSiblingIndex(0), m_nNumActiveChildren(0), m_ptActiveChild(0), m_nRadius(20), m_ptShape(getShape(TACTO_LOOPTYPE_DRUMS, 20)) {}; ///< Default constructor
 	void									addChild(ofxTactoSHPMNode* _pChild); ///< Adds a child node.
 	ofColor									getColor() { return m_nColor; } ///< Returns the colour of the node. \return The colour of the node.
-	vector<ofxTactoSHPMNode*>				getChildren(); ///< Returns the vector of children of the node.
+	const vector<ofxTactoSHPMNode*>&		getChildren(); ///< Returns the vector of children of the node.
+	ofxTactoSHPMNode*						getParent() { return m_ptParent; } ///< Returns the parent of the node. \return The parent node, or 0 for a root.
+	int										getDepth(); ///< Returns the number of ancestors of the node.
+	int										getHeight() { return m_nHeight; } ///< Returns the number of levels below the node. \return The depth of the subtree of the node (0 for a leaf).
+	int										getSubtreeSize() { return m_nSubtreeSize; } ///< Returns the number of nodes in the subtree of the node. \return The number of nodes, the node itself included.
+	const vector<int>&						getLevelCounts() { return m_levelCounts; } ///< Returns the number of nodes at each level of the subtree. \return The counts, the node itself being level 0.
 	bool									isActive(); ///< Returns true if and only if the node is active.
+	int										getSiblingIndex() { return m_nSiblingIndex; } ///< Returns the index of the node among the children of its parent. \return The index, 0 for a root.
+	int										getNumActiveChildren() { return m_nNumActiveChildren; } ///< Returns the number of active children of the node. \return The number of active children.
+	ofxTactoSHPMNode*						getActiveChild() { return m_ptActiveChild; } ///< Returns the active child of the node, when it has exactly one. \return The active child, or 0 when none or several children are active.
 	void									setActive(bool _active); ///< Makes the node active or not. \param _active Whether or not the node should be active.
 	bool									isPointInside(ofPoint pt); ///< Returns true if and only if the specified coordinates are within the button.
 	void									draw(); ///< Draws the node.
@@ -38,16 +57,24 @@ public:
 	void									setOriginInit(ofPoint _origin, bool fullRange); ///< Sets the point of origin of the node, without the dragged offset.
 	int										getRadius(); ///< Returns the radius in pixels of the node.
 	void									setRadius(int _nRadius); ///< Sets the radius in pixels of the node.
+	static const ofxTactoSHPMShape*			getShape(TACTO_LOOPTYPE _type, int _nRadius); ///< Returns the shared shape of the nodes of a type and radius.
 	
 private:
 	TACTO_LOOPTYPE							m_nType; ///< The type of loop that the node represents.
 	ofColor									m_nColor; ///< The colour of the menu node.
 	vector<ofxTactoSHPMNode*>				m_children; ///< The children nodes below this node.
+	ofxTactoSHPMNode*						m_ptParent; ///< The node above this node, or 0.
+	int										m_nHeight; ///< The number of levels below this node.
+	int										m_nSubtreeSize; ///< The number of nodes in the subtree, this node included.
+	vector<int>								m_levelCounts; ///< The number of nodes at each level of the subtree, this node being level 0.
 	bool									m_bActive; ///< Whether or not the node is activated.
+	int										m_nSiblingIndex; ///< The index of this node among the children of its parent.
+	int										m_nNumActiveChildren; ///< The number of active children, kept up to date by setActive().
+	ofxTactoSHPMNode*						m_ptActiveChild; ///< The active child when there is exactly one, or 0.
 	ofPoint									m_ptOrigin; ///< The point of origin of the node, including dragging motion.
 	ofPoint									m_ptOriginalPosition; ///< The original position of the node.
 	int										m_nRadius; ///< The radius of the node.
-	vector<ofPoint*>						m_vertices; ///< The vertex coordinates of the shape, relative to the origin.
+	const ofxTactoSHPMShape*				m_ptShape; ///< The shape of the node, from the shared shape table (see getShape()).
 };
 
 #endif
\ No newline at end of file
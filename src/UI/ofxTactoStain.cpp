@@ -1,4 +1,7 @@
 #include "UI/ofxTactoStain.h"
+#include "ofxTactoLatencyMonitor.h"
+
+unsigned int ofxTactoStain::s_nLabelRebuilds = 0;
 
 //------------------------------------------------------------------
 /** \param _nVertices The number of vertices in the stain.
@@ -9,7 +12,11 @@ void ofxTactoStain::setup(int _nVertices, string _name, float _fRadius)
 {
 	// From input
 	m_fRadius = _fRadius;
-	m_nNumVertices = _nVertices;
+	m_nSetupVertices = (int)ofClamp(_nVertices, STAIN_MIN_VERTICES, VERTICES_MAX);
+	m_nNumVertices = 0;
+	m_bAdaptive = false;
+	m_fMaxEdge = STAIN_DEFAULT_MAX_EDGE;
+	m_fFlatAngle = STAIN_DEFAULT_FLAT_ANGLE;
 
 	// Default values
 	m_nColor1 = 0x0A0A0A;
@@ -28,11 +35,19 @@ void ofxTactoStain::setup(int _nVertices, string _name, float _fRadius)
 	m_bShapable = true;
 	m_nTimeFirstFinger = 0;
 	m_fOriAngle = 0;
+	m_bMeshDirty = true;
+	m_nMeshWidth = m_nMeshHeight = 0;
+	m_nMeshRebuilds = 0;
 
 	m_nameText.init("fonts/arial.ttf", 20);
 	m_sNameInfo = _name;
 	m_nameText.setText(m_sNameInfo);
 	m_nameText.wrapTextX(ofGetWidth() * 3/4);
+	m_nameText.setColor(189, 189, 189, 255);
+	m_nLabelPrecision = STAIN_LABEL_DEFAULT_PRECISION;
+	m_nLabelThrottle = 0;
+	m_nLabelTime = 0;
+	m_bLabelValid = false;
 }
 
 /** \param _bActive The value to assign.
@@ -72,6 +87,28 @@ void ofxTactoStain::setColors(int _nLowGradientColor, int _nHighGradientColor)
 	m_nColor2 = _nHighGradientColor;
 }
 
+/** \return The number of vertices, which differs from the one given to setup() when the resolution is adaptive.
+*/
+int ofxTactoStain::getNumVertices()
+{
+	return m_nNumVertices;
+}
+
+/** \note Splitting adds a vertex in the middle of an edge longer than _fMaxEdge. A vertex is removed when
+* its internal angle is within _fFlatAngle of 180 degrees and the edge that replaces it is no longer than
+* _fMaxEdge, so that a split edge is never merged back. Dragged vertices are never removed.
+* \param _bAdaptive Whether or not the stain adapts its number of vertices (between STAIN_MIN_VERTICES and VERTICES_MAX).
+* \param _fMaxEdge The length beyond which an edge is split, in [0;1] units.
+* \param _fFlatAngle The deviation from 180 degrees, in degrees, under which a vertex is removed.
+*/
+void ofxTactoStain::setAdaptiveResolution(bool _bAdaptive, float _fMaxEdge, float _fFlatAngle)
+{
+	m_bAdaptive = _bAdaptive;
+	m_fMaxEdge = _fMaxEdge;
+	m_fFlatAngle = _fFlatAngle;
+	m_bResolutionDirty = true;
+}
+
 /**
 * \return True if and only if the stain is alive
 */
@@ -107,6 +144,74 @@ ofPoint ofxTactoStain::getOrigin()
 	return ofPoint(m_fOriX, m_fOriY, 0);
 }
 
+/** \note Fewer decimals mean fewer updates of the label while the stain moves. By default (-1), the values are
+* not rounded and shown as ofToString() formats them, so the label changes whenever a value does.
+* \param _nDecimals The number of decimals of the origin, spikiness and area in the label, or -1 not to round them.
+*/
+void ofxTactoStain::setLabelPrecision(int _nDecimals)
+{
+	m_nLabelPrecision = _nDecimals;
+	m_bLabelValid = false;
+}
+
+/** \param _nMilliseconds The shortest time between two updates of the label (0 updates it as soon as a value changes).
+*/
+void ofxTactoStain::setLabelThrottle(int _nMilliseconds)
+{
+	m_nLabelThrottle = _nMilliseconds;
+}
+
+/** \note Sample it once per frame to get the number of rebuilds per frame. Idle stains rebuild nothing.
+* \return The number of times a stain laid its label out again, since the application started.
+*/
+unsigned int ofxTactoStain::getLabelRebuildCount()
+{
+	return s_nLabelRebuilds;
+}
+
+void ofxTactoStain::updateLabel()
+{
+	// Compare the values as they would be displayed
+	double values[4] = { m_fOriX, m_fOriY, m_fSpikiness, m_fArea };
+	if (m_nLabelPrecision >= 0)
+	{
+		double scale = pow(10.0, m_nLabelPrecision);
+		for (int i = 0; i < 4; i++)
+		{
+			values[i] = floor(values[i] * scale + 0.5);
+		}
+	}
+	if (m_bLabelValid && values[0] == m_labelValues[0] && values[1] == m_labelValues[1] &&
+		values[2] == m_labelValues[2] && values[3] == m_labelValues[3])
+		return;
+	unsigned long long now = ofGetElapsedTimeMillis();
+	if (m_bLabelValid && now < m_nLabelTime + m_nLabelThrottle)
+		return;
+
+	for (int i = 0; i < 4; i++)
+	{
+		m_labelValues[i] = values[i];
+	}
+	m_nLabelTime = now;
+	m_bLabelValid = true;
+	s_nLabelRebuilds++;
+
+	std::string sToDisplay;
+	if (m_nLabelPrecision < 0)
+		sToDisplay = m_sNameInfo + " [" + ofToString(m_fOriX) + "; " + ofToString(m_fOriY) + "] Spikiness=" + ofToString(m_fSpikiness) + " Area=" + ofToString(m_fArea);
+	else
+		sToDisplay = m_sNameInfo + " [" + ofToString(m_fOriX, m_nLabelPrecision) + "; " + ofToString(m_fOriY, m_nLabelPrecision) +
+			"] Spikiness=" + ofToString(m_fSpikiness, m_nLabelPrecision) + " Area=" + ofToString(m_fArea, m_nLabelPrecision);
+	m_nameText.setText(sToDisplay);
+}
+
+/** \return The current colour of the stain, in the range of its gradient (see setColorGradient()).
+*/
+int ofxTactoStain::getCurrentColor()
+{
+	return m_nCurrentColor;
+}
+
 /** \param _fGradient A value in [0;1] in which 0 is mapped to m_nColor1 and 1 to m_nColor2
 */
 void ofxTactoStain::setColorGradient(float _fGradient)
@@ -135,6 +240,7 @@ void ofxTactoStain::setColorGradient(float _fGradient)
 
 void ofxTactoStain::reset()
 {
+	setNumVertices(m_nSetupVertices);
 	// All positions are relative to the (oriX, oriY) point
 	for (int i = 0; i < m_nNumVertices; i++)
 	{
@@ -142,11 +248,16 @@ void ofxTactoStain::reset()
 		float currentAngle = 2 * PI * i / m_nNumVertices;
 		vertices[i].x = m_fRadius * cos(currentAngle);
 		vertices[i].y = m_fRadius * sin(currentAngle);
+		vertices[i].bBeingDragged = false;
 	}
+	shapeChanged();
 }
 
+/** \note Nothing is recomputed when no vertex moved since the last update.
+*/
 void ofxTactoStain::update()
 {
+	adaptResolution();
 	m_fSpikiness = spikiness();
 	m_fArea = area();
 	m_nCounter += 1;
@@ -154,61 +265,40 @@ void ofxTactoStain::update()
 		m_nCounter = 0;
 }
 
+/** \note The meshes are only rebuilt when the shape changes; moving the stain only changes the
+* transform they are drawn with.
+*/
 void ofxTactoStain::draw()
 {
 	if (m_bActive)
 	{
-		ofFill();
-		ofSetHexColor(m_nCurrentColor);
-		ofBeginShape();
+		ofxTactoLatencyMonitor::get().mark(TACTO_LATENCY_DRAW);
+		updateMeshes();
 
-		for (int i = 0; i < m_nNumVertices; i++)
-		{
-			// sorry about all the if/states here, but to do catmull rom curves
-			// we need to duplicate the start and end points so the curve acutally
-			// goes through them.
-
-			// for i == 0, we just call the vertex twice
-			// for i == nCurveVertexes-1 (last point) we call vertex 0 twice
-			// otherwise just normal ofCurveVertex call
-			if (i == 0)
-			{
-				ofCurveVertex((m_fOriX + vertices[0].x) * ofGetWidth(), (m_fOriY + vertices[0].y) * ofGetHeight()); // we need to duplicate 0 for the curve to start at point 0
-				ofCurveVertex((m_fOriX + vertices[0].x) * ofGetWidth(), (m_fOriY + vertices[0].y) * ofGetHeight()); // we need to duplicate 0 for the curve to start at point 0
-			}
-			else if (i == m_nNumVertices - 1)
-			{
-				ofCurveVertex((m_fOriX + vertices[i].x) * ofGetWidth(), (m_fOriY + vertices[i].y) * ofGetHeight());
-				ofCurveVertex((m_fOriX + vertices[0].x) * ofGetWidth(), (m_fOriY + vertices[0].y) * ofGetHeight());	// to draw a curve from pt m_nNumVertices-1 to pt 0
-				ofCurveVertex((m_fOriX + vertices[0].x) * ofGetWidth(), (m_fOriY + vertices[0].y) * ofGetHeight());	// we duplicate the first point twice
-			}
-			else
-			{
-				ofCurveVertex((m_fOriX + vertices[i].x) * ofGetWidth(), (m_fOriY + vertices[i].y) * ofGetHeight());
-			}
-		}
-		ofEndShape();
+		ofPushMatrix();
+		ofTranslate(m_fOriX * ofGetWidth(), m_fOriY * ofGetHeight());
+		ofSetHexColor(m_nCurrentColor);
+		m_fillMesh.draw();
 		// show a faint the non-curve version of the same polygon:
-		ofNoFill();
 		ofSetColor(0,0,128,40);
-		ofBeginShape();
-		for (int i = 0; i < m_nNumVertices; i++)
-		{
-			ofVertex((m_fOriX + vertices[i].x) * ofGetWidth(), (m_fOriY + vertices[i].y) * ofGetHeight());
-		}
-		ofEndShape(true);
+		m_outlineMesh.draw();
 		ofSetColor(0,0,0,80);
-		for (int i = 0; i < m_nNumVertices; i++)
-		{
-			if (vertices[i].bBeingDragged == true) ofFill();
-			else ofNoFill();
-			ofCircle((m_fOriX + vertices[i].x) * ofGetWidth(), (m_fOriY + vertices[i].y) * ofGetHeight(), m_fVertexRadius);
-		}
+		m_draggedHandlesMesh.draw();
+		m_handlesMesh.draw();
+		ofPopMatrix();
 
+		drawLabel();
+	}
+}
+
+/** \note draw() calls it; \link ofxTactoStainBatch calls it after the shapes of all its stains.
+*/
+void ofxTactoStain::drawLabel()
+{
+	if (m_bActive)
+	{
 		// Draw the name of the stain
-		std::string sToDisplay = m_sNameInfo + " [" + ofToString(m_fOriX) + "; " + ofToString(m_fOriY) + "] Spikiness=" + ofToString(m_fSpikiness) + " Area=" + ofToString(m_fArea);
-		m_nameText.setText(sToDisplay);
-		m_nameText.setColor(189, 189, 189, 255);
+		updateLabel();
 		m_nameText.drawCenter(m_fOriX * ofGetWidth(), m_fOriY * ofGetHeight());
 	}
 }
@@ -219,18 +309,8 @@ void ofxTactoStain::draw()
 float ofxTactoStain::area()
 {
 	// based on http://www.alienryderflex.com/polygon_area/
-	float area = 0.;
-	int j = 0;
-
-	for (int i = 0; i < m_nNumVertices; i++)
-	{
-		j++;
-		if (j == m_nNumVertices)
-			j=0;
-		area += (vertices[i].x + vertices[j].x) * (vertices[i].y - vertices[j].y);
-	}
-
-	float fReturnValue = area * .5 / m_fInitialSize;
+	updateShapeTerms();
+	float fReturnValue = m_fAreaSum * .5 / m_fInitialSize;
 	return fReturnValue;
 }
 
@@ -245,41 +325,187 @@ float ofxTactoStain::spikiness()
 float ofxTactoStain::polygonInternalAngles()
 {
 	// a polygon with n sides has a sum of internal angles equal to (n-2)  180
-	float spikiness = 0.;
-	int j = 0;
-	int k = m_nNumVertices - 2;
+	updateShapeTerms();
+	return m_fAngleSum;
+}
 
-	for (int i = 0; i < m_nNumVertices; i++)
+/** \note The vertices kept keep their positions; call shapeChanged() afterwards.
+* \param _nVertices The new number of vertices.
+*/
+void ofxTactoStain::setNumVertices(int _nVertices)
+{
+	vertices.resize(_nVertices);
+	m_vertexDirty.resize(_nVertices);
+	m_areaTerms.resize(_nVertices);
+	m_angleTerms.resize(_nVertices);
+	m_nNumVertices = _nVertices;
+}
+
+/** \note Runs once per change of the vertices, in linear time. The edges are split first, then the flat
+* vertices removed; the next update() carries on if that is not enough.
+*/
+void ofxTactoStain::adaptResolution()
+{
+	if (!m_bAdaptive || !m_bResolutionDirty)
+		return;
+	m_bResolutionDirty = false;
+
+	float fMaxEdgeSq = m_fMaxEdge * m_fMaxEdge;
+	bool bChanged = false;
+
+	// Split the stretched edges
+	for (int i = 0; i < m_nNumVertices && m_nNumVertices < VERTICES_MAX; i++)
+	{
+		int j = i == m_nNumVertices - 1 ? 0 : i + 1;
+		float dx = vertices[j].x - vertices[i].x;
+		float dy = vertices[j].y - vertices[i].y;
+		if (dx*dx + dy*dy > fMaxEdgeSq)
+		{
+			ofxTactoVertex middle;
+			middle.x = (vertices[i].x + vertices[j].x) / 2;
+			middle.y = (vertices[i].y + vertices[j].y) / 2;
+			middle.xOriScale = (vertices[i].xOriScale + vertices[j].xOriScale) / 2;
+			middle.yOriScale = (vertices[i].yOriScale + vertices[j].yOriScale) / 2;
+			middle.bBeingDragged = false;
+			vertices.insert(i + 1, middle);
+			m_nNumVertices++;
+			bChanged = true;
+		}
+	}
+
+	// Remove the flat vertices
+	for (int i = 0; i < m_nNumVertices && m_nNumVertices > STAIN_MIN_VERTICES; )
 	{
-		j++;
-		k++;
-		// Take care of bounds
-		if (j == m_nNumVertices)
-			j = 0;
-		if (k == m_nNumVertices)
-			k = 0;
-		// Consider angle at point i, so vectors v1 from pt i to pt j and v2 from pt i to pt k
-		// A * B = v1_x * v2_x + v1_y * v2_x
-		float v1_x = vertices[j].x - vertices[i].x;
-		float v1_y = vertices[j].y - vertices[i].y;
-		float v1_len = sqrt (v1_x * v1_x + v1_y * v1_y);
-		float v2_x = vertices[k].x - vertices[i].x;
-		float v2_y = vertices[k].y - vertices[i].y;
-		float v2_len = sqrt (v2_x * v2_x + v2_y * v2_y);
-		float cosTheta = (v1_x * v2_x + v1_y * v2_y) / (v1_len * v2_len);
-		float theta = 0;
-		if (cosTheta == 1)
-			theta = 0;
-		else if (cosTheta == 0)
-			theta = PI / 2;
+		int prev = i == 0 ? m_nNumVertices - 1 : i - 1;
+		int next = i == m_nNumVertices - 1 ? 0 : i + 1;
+		float dx = vertices[next].x - vertices[prev].x;
+		float dy = vertices[next].y - vertices[prev].y;
+		if (!vertices[i].bBeingDragged && dx*dx + dy*dy <= fMaxEdgeSq && angleTerm(i) >= 180 - m_fFlatAngle)
+		{
+			vertices.erase(i);
+			m_nNumVertices--;
+			bChanged = true;
+		}
 		else
-			theta = acos(cosTheta);
-		float thetaDeg = theta * 180 / PI;
+		{
+			i++;
+		}
+	}
+
+	if (bChanged)
+	{
+		setNumVertices(m_nNumVertices);
+		shapeChanged();
+	}
+}
+
+/** \param _nVertex The vertex that moved.
+*/
+void ofxTactoStain::vertexMoved(int _nVertex)
+{
+	m_vertexDirty[_nVertex] = true;
+	m_bResolutionDirty = true;
+	m_bShapeDirty = true;
+	m_bBoundsDirty = true;
+	m_bMeshDirty = true;
+}
+
+void ofxTactoStain::shapeChanged()
+{
+	for (int i = 0; i < m_nNumVertices; i++)
+	{
+		m_vertexDirty[i] = true;
+	}
+	m_bResolutionDirty = true;
+	m_bShapeDirty = true;
+	m_bBoundsDirty = true;
+	m_bMeshDirty = true;
+}
+
+/** \note A vertex appears in the area terms of its two edges, and in the angles at itself and at
+* its two neighbours, so only those terms are recomputed when it moves.
+*/
+void ofxTactoStain::updateShapeTerms()
+{
+	if (!m_bShapeDirty)
+		return;
+
+	ofxTactoSmallArray<bool, STAIN_INLINE_VERTICES> areaStale;
+	ofxTactoSmallArray<bool, STAIN_INLINE_VERTICES> angleStale;
+	areaStale.resize(m_nNumVertices);
+	angleStale.resize(m_nNumVertices);
+	for (int i = 0; i < m_nNumVertices; i++)
+	{
+		areaStale[i] = angleStale[i] = false;
+	}
+	for (int i = 0; i < m_nNumVertices; i++)
+	{
+		if (m_vertexDirty[i])
+		{
+			int prev = i == 0 ? m_nNumVertices - 1 : i - 1;
+			int next = i == m_nNumVertices - 1 ? 0 : i + 1;
+			areaStale[prev] = areaStale[i] = true;
+			angleStale[prev] = angleStale[i] = angleStale[next] = true;
+			m_vertexDirty[i] = false;
+		}
+	}
 
-		spikiness += thetaDeg;
+	m_fAreaSum = 0;
+	m_fAngleSum = 0;
+	for (int i = 0; i < m_nNumVertices; i++)
+	{
+		if (areaStale[i])
+			m_areaTerms[i] = areaTerm(i);
+		if (angleStale[i])
+			m_angleTerms[i] = angleTerm(i);
+		// Summing the cached terms again keeps rounding errors from accumulating
+		m_fAreaSum += m_areaTerms[i];
+		m_fAngleSum += m_angleTerms[i];
 	}
+	m_bShapeDirty = false;
+}
 
-	return spikiness;
+/** \param _nVertex The vertex at which the edge starts.
+* \return The area term of the edge from the vertex to the next one.
+*/
+float ofxTactoStain::areaTerm(int _nVertex)
+{
+	int j = _nVertex + 1;
+	if (j == m_nNumVertices)
+		j = 0;
+	return (vertices[_nVertex].x + vertices[j].x) * (vertices[_nVertex].y - vertices[j].y);
+}
+
+/** \param _nVertex The vertex.
+* \return The internal angle of the stain at the vertex, in degrees.
+*/
+float ofxTactoStain::angleTerm(int _nVertex)
+{
+	int i = _nVertex;
+	int j = i + 1;
+	int k = i - 1;
+	// Take care of bounds
+	if (j == m_nNumVertices)
+		j = 0;
+	if (k < 0)
+		k = m_nNumVertices - 1;
+	// Consider angle at point i, so vectors v1 from pt i to pt j and v2 from pt i to pt k
+	// A * B = v1_x * v2_x + v1_y * v2_x
+	float v1_x = vertices[j].x - vertices[i].x;
+	float v1_y = vertices[j].y - vertices[i].y;
+	float v1_len = sqrt (v1_x * v1_x + v1_y * v1_y);
+	float v2_x = vertices[k].x - vertices[i].x;
+	float v2_y = vertices[k].y - vertices[i].y;
+	float v2_len = sqrt (v2_x * v2_x + v2_y * v2_y);
+	float cosTheta = (v1_x * v2_x + v1_y * v2_y) / (v1_len * v2_len);
+	float theta = 0;
+	if (cosTheta == 1)
+		theta = 0;
+	else if (cosTheta == 0)
+		theta = PI / 2;
+	else
+		theta = acos(cosTheta);
+	return theta * 180 / PI;
 }
 
 /**
@@ -297,6 +523,7 @@ void ofxTactoStain::mouseDragged(int x, int y, int button)
 			{
 				vertices[i].x = (float)x/ofGetWidth() - m_fOriX;
 				vertices[i].y = (float)y/ofGetHeight() - m_fOriY;
+				vertexMoved(i);
 			}
 		}
 
@@ -317,22 +544,16 @@ void ofxTactoStain::mousePressed(int x, int y, int button)
 {
 	if (m_bActive)
 	{
-		bool bGrabbedVertex = false;
-		// Move vertices
-		for (int i = 0; i < m_nNumVertices; i++)
+		// Move vertices. Do not allow several vertices to be grabbed at the same time
+		int nGrabbed = grabbableVertex((float)x/ofGetWidth(), (float)y/ofGetHeight());
+		bool bGrabbedVertex = nGrabbed >= 0;
+		for (int i = 0; i < (bGrabbedVertex ? nGrabbed : m_nNumVertices); i++)
 		{
-			float diffx = (float)x/ofGetWidth() - (m_fOriX + vertices[i].x);
-			float diffy = (float)y/ofGetHeight() - (m_fOriY + vertices[i].y);
-			float dist = sqrt(diffx*diffx + diffy*diffy);
-			if (dist < m_fVertexRadius)
-			{
-				vertices[i].bBeingDragged = true;
-				bGrabbedVertex = true;
-				break; // Do not allow several vertices to be grabbed at the same time
-			}
-			else
-				vertices[i].bBeingDragged = false;
+			vertices[i].bBeingDragged = false;
 		}
+		if (bGrabbedVertex)
+			vertices[nGrabbed].bBeingDragged = true;
+		m_bMeshDirty = true; // The handles show which vertices are dragged
 
 		if (!bGrabbedVertex) // No vertex was moved, so see if we move/rotate/scale the stain
 		{
@@ -362,6 +583,7 @@ void ofxTactoStain::mouseReleased(int x, int y, int button)
 		{
 			vertices[i].bBeingDragged = false;
 		}
+		m_bMeshDirty = true;
 		if (m_bInMotion)
 		{
 			m_bInMotion = false;
@@ -381,21 +603,16 @@ void ofxTactoStain::touchDown(float x, float y, int touchId)
 	{
 		if(m_bShapable)
 		{
-			// Lock the first item we find
-			for (int i = 0; i < m_nNumVertices; i++)
+			// Lock the first item we find. Do not allow several vertices to be grabbed at the same time
+			int nGrabbed = grabbableVertex(x, y);
+			bGrabbedVertex = nGrabbed >= 0;
+			for (int i = 0; i < (bGrabbedVertex ? nGrabbed : m_nNumVertices); i++)
 			{
-				float diffx = x - (m_fOriX + vertices[i].x);
-				float diffy = y - (m_fOriY + vertices[i].y);
-				float dist = sqrt(diffx*diffx + diffy*diffy);
-				if (dist < m_fVertexRadius)
-				{
-					vertices[i].bBeingDragged = true;
-					bGrabbedVertex = true;
-					break; // Do not allow several vertices to be grabbed at the same time
-				}
-				else
-					vertices[i].bBeingDragged = false;
+				vertices[i].bBeingDragged = false;
 			}
+			if (bGrabbedVertex)
+				vertices[nGrabbed].bBeingDragged = true;
+			m_bMeshDirty = true; // The handles show which vertices are dragged
 		}
 
 		if (!bGrabbedVertex) // did not find a vertex to grab
@@ -456,11 +673,13 @@ void ofxTactoStain::touchMoved(float x, float y, int touchId)
 {
 	if (m_bActive)
 	{
+		ofxTactoLatencyMonitor::get().mark(TACTO_LATENCY_WIDGET);
 		for (int i = 0; i < m_nNumVertices; i++)
 		{
 			if (vertices[i].bBeingDragged == true){
 				vertices[i].x = x - m_fOriX;
 				vertices[i].y = y - m_fOriY;
+				vertexMoved(i);
 			}
 		}
 
@@ -519,6 +738,33 @@ void ofxTactoStain::touchMoved(float x, float y, int touchId)
 			vertices[i].x = x2 * scaleFactor;
 			vertices[i].y = y2 * scaleFactor;
 		}
+		shapeChanged();
+	}
+}
+
+/** \note Register with ofAddListener(handler.touchBatch, &stain, &ofxTactoStain::touchBatch) and
+* disable the handler's legacy events to receive every touch of a frame in one call.
+* \param _args The touch changes of the frame.
+*/
+void ofxTactoStain::touchBatch(ofxTactoTouchBatchEventArgs& _args)
+{
+	for (int i = 0; i < _args.numEvents; i++)
+	{
+		const ofxTactoTouchEvent& event = _args.events[i];
+		switch (event.type)
+		{
+			case TACTO_TOUCH_DOWN:
+				touchDown(event.x, event.y, event.id);
+				break;
+			case TACTO_TOUCH_MOVED:
+				touchMoved(event.x, event.y, event.id);
+				break;
+			case TACTO_TOUCH_UP:
+				touchUp(event.x, event.y, event.id);
+				break;
+			default:
+				break;
+		}
 	}
 }
 
@@ -559,16 +805,11 @@ void ofxTactoStain::touchUp(float x, float y, int touchId)
 	if (m_bActive)
 	{
 		// Unlock corresponding vertex
-		for (int i = 0; i < m_nNumVertices; i++)
+		int nReleased = grabbableVertex(x, y);
+		if (nReleased >= 0)
 		{
-			float diffx = x - (m_fOriX + vertices[i].x);
-			float diffy = y - (m_fOriY + vertices[i].y);
-			float dist = sqrt(diffx*diffx + diffy*diffy);
-			if (dist < m_fVertexRadius)
-			{
-				vertices[i].bBeingDragged = false;
-				break;
-			}
+			vertices[nReleased].bBeingDragged = false;
+			m_bMeshDirty = true;
 		}
 
 		// Kill motion
@@ -588,15 +829,14 @@ void ofxTactoStain::touchUp(float x, float y, int touchId)
 	}
 }
 
-/** \note See http://paulbourke.net/geometry/insidepoly/ for reference.
+/** \note See http://paulbourke.net/geometry/insidepoly/ for reference. Points outside of the
+* bounding box or circle of the stain are rejected before the full test.
 * \param x The x coordinate of the point to evaluate
 * \param y The y coordinate of the point to evaluate
 * \param fullRange Whether or not the coordinates of the queried point are in pixels (false means [0-1]).
 */
 bool ofxTactoStain::isPointInside(float x, float y, bool fullRange)
 {
-	int i, j;
-	bool inShape = false;
 	float xWorld = x;
 	float yWorld = y;
 
@@ -605,13 +845,30 @@ bool ofxTactoStain::isPointInside(float x, float y, bool fullRange)
 		xWorld /= ofGetWidth();
 		yWorld /= ofGetHeight();
 	}
-	for (i = 0, j = m_nNumVertices-1; i < m_nNumVertices; j = i++) {
-		if ((((m_fOriY + vertices[i].y <= yWorld) && (yWorld < m_fOriY + vertices[j].y)) ||
-			((m_fOriY + vertices[j].y <= yWorld) && (yWorld < m_fOriY + vertices[i].y))) &&
-			(xWorld < (vertices[j].x - vertices[i].x) * (yWorld - m_fOriY - vertices[i].y) / (vertices[j].y - vertices[i].y) + m_fOriX + vertices[i].x))
-			inShape = !inShape;
-	}
-	return inShape;
+
+	// Early rejection, relative to the origin
+	updateBounds();
+	float xLocal = xWorld - m_fOriX;
+	float yLocal = yWorld - m_fOriY;
+	if (xLocal < m_fBoundsMinX || xLocal > m_fBoundsMaxX || yLocal < m_fBoundsMinY || yLocal > m_fBoundsMaxY)
+		return false;
+	if (xLocal*xLocal + yLocal*yLocal > m_fBoundsRadiusSq)
+		return false;
+
+	return TactoGeometry::pointInPolygon(m_vertexXs.data(), m_vertexYs.data(), m_prevVertexXs.data(), m_prevVertexYs.data(), m_nNumVertices, xLocal, yLocal);
+}
+
+/** \note All the points are tested at once against each edge (see TactoGeometry::pointsInPolygon()).
+* \param _xs The x coordinates of the points, in [0;1].
+* \param _ys The y coordinates of the points, in [0;1].
+* \param _nPoints The number of points.
+* \param _results For each point, whether or not it is within the stain.
+*/
+void ofxTactoStain::arePointsInside(const float* _xs, const float* _ys, int _nPoints, bool* _results)
+{
+	updateBounds();
+	TactoGeometry::pointsInPolygon(m_vertexXs.data(), m_vertexYs.data(), m_prevVertexXs.data(), m_prevVertexYs.data(), m_nNumVertices,
+		_xs, _ys, _nPoints, m_fOriX, m_fOriY, _results);
 }
 
 /** \brief This function determines whether or not the queried position is close to the stain.
@@ -622,8 +879,6 @@ This is determined by figuring out whether or not the position is close to the v
 */
 bool ofxTactoStain::isPointClose(float x, float y, bool fullRange)
 {
-	int i, j;
-	bool closeToShape = false;
 	float xWorld = x;
 	float yWorld = y;
 
@@ -632,19 +887,204 @@ bool ofxTactoStain::isPointClose(float x, float y, bool fullRange)
 		xWorld /= ofGetWidth();
 		yWorld /= ofGetHeight();
 	}
-	for (i = 0; i < m_nNumVertices; i++)
+
+	// Early rejection: the point must be within the bounds grown by the radius of the vertices
+	updateBounds();
+	float xLocal = xWorld - m_fOriX;
+	float yLocal = yWorld - m_fOriY;
+	if (xLocal < m_fBoundsMinX - m_fVertexRadius || xLocal > m_fBoundsMaxX + m_fVertexRadius ||
+		yLocal < m_fBoundsMinY - m_fVertexRadius || yLocal > m_fBoundsMaxY + m_fVertexRadius)
+		return false;
+	float fReach = m_fBoundsRadius + m_fVertexRadius;
+	if (xLocal*xLocal + yLocal*yLocal > fReach*fReach)
+		return false;
+
+	if (TactoGeometry::firstVertexWithin(m_vertexXs.data(), m_vertexYs.data(), m_nNumVertices, xLocal, yLocal, m_fVertexRadius*m_fVertexRadius) >= 0)
+		return true;
+	// If the point is inside the shape, it is close to it!
+	return isPointInside(xWorld, yWorld, false);
+}
+
+/** \note The box includes the grab radius of the vertices, since a touch near a vertex grabs it.
+* \param _bounds The bounding box of the stain.
+* \return Whether or not the stain takes touches (it does when it is active).
+*/
+bool ofxTactoStain::getTouchBounds(ofRectangle& _bounds)
+{
+	if (!m_bActive || m_nNumVertices == 0)
+		return false;
+
+	updateBounds();
+	_bounds.x = m_fOriX + m_fBoundsMinX - m_fVertexRadius;
+	_bounds.y = m_fOriY + m_fBoundsMinY - m_fVertexRadius;
+	_bounds.width = m_fBoundsMaxX - m_fBoundsMinX + 2 * m_fVertexRadius;
+	_bounds.height = m_fBoundsMaxY - m_fBoundsMinY + 2 * m_fVertexRadius;
+	return true;
+}
+
+/** \param x The x coordinate of the touch, in [0;1].
+* \param y The y coordinate of the touch, in [0;1].
+* \return Whether or not the touch is close to the stain (see isPointClose()).
+*/
+bool ofxTactoStain::hitTest(float x, float y)
+{
+	return isPointClose(x, y, false);
+}
+
+/** \note The curve goes through every vertex, as with ofCurveVertex(): the Catmull-Rom control
+* points are the vertices, with the first one repeated at both ends.
+*/
+void ofxTactoStain::updateMeshes()
+{
+	int nWidth = ofGetWidth();
+	int nHeight = ofGetHeight();
+	if (!m_bMeshDirty && nWidth == m_nMeshWidth && nHeight == m_nMeshHeight)
+		return;
+
+	// Control points: 0, 0, 1, ..., n-1, 0, 0
+	int nControls = m_nNumVertices + 3;
+
+	// Outline and fill
+	m_curve.clear();
+	for (int i = 0; i + 3 < nControls; i++)
 	{
-		float diffx = xWorld - (m_fOriX + vertices[i].x);
-		float diffy = yWorld - (m_fOriY + vertices[i].y);
-		float dist = sqrt(diffx*diffx + diffy*diffy);
-		if (dist < m_fVertexRadius)
+		ofPoint p0, p1, p2, p3;
+		ofPoint* segment[4] = { &p0, &p1, &p2, &p3 };
+		for (int k = 0; k < 4; k++)
 		{
-			closeToShape = true;
-			break;
+			int v = (i + k <= 1 || i + k >= m_nNumVertices + 1) ? 0 : i + k - 1;
+			segment[k]->set(vertices[v].x * nWidth, vertices[v].y * nHeight);
+		}
+		for (int step = 0; step < STAIN_CURVE_RESOLUTION; step++)
+		{
+			float t = (float)step / STAIN_CURVE_RESOLUTION;
+			float t2 = t * t;
+			float t3 = t2 * t;
+			m_curve.addVertex(0.5f * (2 * p1.x + (p2.x - p0.x) * t + (2 * p0.x - 5 * p1.x + 4 * p2.x - p3.x) * t2 + (3 * p1.x - p0.x - 3 * p2.x + p3.x) * t3),
+				0.5f * (2 * p1.y + (p2.y - p0.y) * t + (2 * p0.y - 5 * p1.y + 4 * p2.y - p3.y) * t2 + (3 * p1.y - p0.y - 3 * p2.y + p3.y) * t3));
 		}
 	}
-	// If the point is inside the shape, it is close to it!
-	return closeToShape || isPointInside(x, y, fullRange);
+	m_curve.close();
+	m_fillMesh.clear();
+	m_tessellator.tessellateToMesh(m_curve, OF_POLY_WINDING_ODD, m_fillMesh, true);
+
+	m_outlineMesh.clear();
+	m_outlineMesh.setMode(OF_PRIMITIVE_LINE_LOOP);
+	for (int i = 0; i < m_nNumVertices; i++)
+	{
+		m_outlineMesh.addVertex(ofVec3f(vertices[i].x * nWidth, vertices[i].y * nHeight, 0));
+	}
+
+	// Vertex handles: filled when dragged, outlined otherwise
+	m_draggedHandlesMesh.clear();
+	m_draggedHandlesMesh.setMode(OF_PRIMITIVE_TRIANGLES);
+	m_handlesMesh.clear();
+	m_handlesMesh.setMode(OF_PRIMITIVE_LINES);
+	for (int i = 0; i < m_nNumVertices; i++)
+	{
+		ofVec3f centre(vertices[i].x * nWidth, vertices[i].y * nHeight, 0);
+		for (int step = 0; step < STAIN_HANDLE_RESOLUTION; step++)
+		{
+			float angle1 = TWO_PI * step / STAIN_HANDLE_RESOLUTION;
+			float angle2 = TWO_PI * (step + 1) / STAIN_HANDLE_RESOLUTION;
+			ofVec3f p1 = centre + ofVec3f(cos(angle1), sin(angle1), 0) * m_fVertexRadius;
+			ofVec3f p2 = centre + ofVec3f(cos(angle2), sin(angle2), 0) * m_fVertexRadius;
+			ofVboMesh& handles = vertices[i].bBeingDragged ? m_draggedHandlesMesh : m_handlesMesh;
+			if (vertices[i].bBeingDragged)
+				handles.addVertex(centre);
+			handles.addVertex(p1);
+			handles.addVertex(p2);
+		}
+	}
+
+	m_nMeshWidth = nWidth;
+	m_nMeshHeight = nHeight;
+	m_bMeshDirty = false;
+	m_nMeshRebuilds++;
+}
+
+/** \note The bounds are relative to the origin, so moving the stain does not invalidate them.
+*/
+void ofxTactoStain::updateBounds()
+{
+	if (!m_bBoundsDirty)
+		return;
+
+	m_fBoundsMinX = m_fBoundsMaxX = m_nNumVertices > 0 ? vertices[0].x : 0;
+	m_fBoundsMinY = m_fBoundsMaxY = m_nNumVertices > 0 ? vertices[0].y : 0;
+	m_fBoundsRadiusSq = 0;
+	for (int i = 0; i < m_nNumVertices; i++)
+	{
+		m_fBoundsMinX = MIN(m_fBoundsMinX, vertices[i].x);
+		m_fBoundsMaxX = MAX(m_fBoundsMaxX, vertices[i].x);
+		m_fBoundsMinY = MIN(m_fBoundsMinY, vertices[i].y);
+		m_fBoundsMaxY = MAX(m_fBoundsMaxY, vertices[i].y);
+		m_fBoundsRadiusSq = MAX(m_fBoundsRadiusSq, vertices[i].x*vertices[i].x + vertices[i].y*vertices[i].y);
+	}
+	m_fBoundsRadius = sqrt(m_fBoundsRadiusSq);
+
+	// Separate arrays for the hit-test kernels, padded with NaN so that padding never hits
+	int nPadded = TactoGeometry::paddedCount(m_nNumVertices);
+	m_vertexXs.resize(nPadded);
+	m_vertexYs.resize(nPadded);
+	m_prevVertexXs.resize(nPadded);
+	m_prevVertexYs.resize(nPadded);
+	for (int i = 0; i < m_nNumVertices; i++)
+	{
+		int prev = i == 0 ? m_nNumVertices - 1 : i - 1;
+		m_vertexXs[i] = vertices[i].x;
+		m_vertexYs[i] = vertices[i].y;
+		m_prevVertexXs[i] = vertices[prev].x;
+		m_prevVertexYs[i] = vertices[prev].y;
+	}
+	for (int i = m_nNumVertices; i < nPadded; i++)
+	{
+		m_vertexXs[i] = m_vertexYs[i] = m_prevVertexXs[i] = m_prevVertexYs[i] = NAN;
+	}
+	m_bBoundsDirty = false;
+}
+
+/** \param x The x coordinate of the point, in [0;1].
+* \param y The y coordinate of the point, in [0;1].
+* \return The first vertex within the grab radius of the point, or -1 if there is none.
+*/
+int ofxTactoStain::grabbableVertex(float x, float y)
+{
+	updateBounds();
+	return TactoGeometry::firstVertexWithin(m_vertexXs.data(), m_vertexYs.data(), m_nNumVertices, x - m_fOriX, y - m_fOriY, m_fVertexRadius*m_fVertexRadius);
+}
+
+/** \note Add the origin (in pixels) to get screen coordinates.
+* \return The triangles that fill the stain.
+*/
+const ofMesh& ofxTactoStain::getFillMesh()
+{
+	updateMeshes();
+	return m_fillMesh;
+}
+
+/** \return The polygon of the vertices, as a line loop.
+*/
+const ofMesh& ofxTactoStain::getOutlineMesh()
+{
+	updateMeshes();
+	return m_outlineMesh;
+}
+
+/** \param _bDragged Whether to return the handles of the dragged vertices (filled triangles) or of the others (lines).
+* \return The circles around the vertices.
+*/
+const ofMesh& ofxTactoStain::getHandlesMesh(bool _bDragged)
+{
+	updateMeshes();
+	return _bDragged ? m_draggedHandlesMesh : m_handlesMesh;
+}
+
+/** \return The number of times the meshes were rebuilt since the stain was set up.
+*/
+int ofxTactoStain::getMeshRebuildCount()
+{
+	return m_nMeshRebuilds;
 }
 
 /** \return The number of blobs currently inside the stain.
@@ -14,11 +14,22 @@
 *
 */
 
-#define VERTICES_MAX 64
+#define VERTICES_MAX 1024 ///< The largest number of vertices of a stain, adaptive resolution included
+#define STAIN_MIN_VERTICES 3 ///< The smallest number of vertices of a stain
+#define STAIN_INLINE_VERTICES 16 ///< The number of vertices a stain holds without allocating
+#define STAIN_DEFAULT_MAX_EDGE 0.1f ///< The default length beyond which adaptive resolution splits an edge
+#define STAIN_DEFAULT_FLAT_ANGLE 8.0f ///< The default deviation from 180 degrees under which adaptive resolution removes a vertex
 #define MAX_COUNT 65536
+#define STAIN_CURVE_RESOLUTION 20 ///< The number of segments of the outline between two vertices
+#define STAIN_LABEL_DEFAULT_PRECISION -1 ///< The default number of decimals of the values in the label (-1: unrounded, as ofToString() formats them)
+#define STAIN_HANDLE_RESOLUTION 12 ///< The number of segments of the circle around each vertex
 
 #include "ofMain.h"
 #include "ofxTextSuite.h"
+#include "ofxTactoTouchEvent.h"
+#include "UI/ofxTactoTouchTarget.h"
+#include "ofxTactoGeometry.h"
+#include "ofxTactoSmallArray.h"
 
 /** \brief A class that represents an individual vertex, many of which make up a stain.
 */
@@ -54,15 +65,18 @@ public:
 	}
 };
 
-class ofxTactoStain
+class ofxTactoStain : public ofxTactoTouchTarget
 {
 public:
 	void                					setup(int _nVertices, string _name = "", float _fRadius = 0.2f); ///< Configures the stain.
 	void                					update(); ///< Regular OpenFrameworks function.
 	void                					draw(); ///< Regular OpenFrameworks function.
+	void									drawLabel(); ///< Draws the name and values of the stain.
 	void                					reset(); ///< Resets the initial position of all points but the origin.
 	float              						area(); ///< Returns the area of the stain, where 1 is the initial value and negative values represent a stain's opposite side.
 	float               					spikiness(); ///< Returns the 'spikiness' of the stain, where 1 is the initial value. The "spikiness" of a stain is a function of the sum of the internal angles of the stain.
+	int										getNumVertices(); ///< Returns the current number of vertices of the stain.
+	void									setAdaptiveResolution(bool _bAdaptive, float _fMaxEdge = STAIN_DEFAULT_MAX_EDGE, float _fFlatAngle = STAIN_DEFAULT_FLAT_ANGLE); ///< Makes the stain add and remove vertices as its outline stretches and flattens.
 	bool									isActive(); ///< Returns true if the stain is active.
 	void									setActive(bool _bActive); ///< Makes the stain active or not. When a stain is active, it is displayed and can be modified.
 	bool									isInMotion(); ///< Returns true if the stain is moving.
@@ -72,10 +86,21 @@ public:
 	void									setOrigin(float _fOriX, float _fOriY); ///< Sets the origin of the stain.
 	ofPoint									getOrigin(); ///< Returns the origin of the stain.
 	void									setColors(int _nLowGradientColor, int _nHighGradientColor); ///< Sets the two colours that determine a colour gradient for the stain.
+	void									setLabelPrecision(int _nDecimals); ///< Sets the number of decimals of the values shown in the label.
+	void									setLabelThrottle(int _nMilliseconds); ///< Sets the shortest time between two updates of the label.
+	static unsigned int						getLabelRebuildCount(); ///< Returns the number of label layouts rebuilt by all the stains.
+	int										getCurrentColor(); ///< Returns the current colour of the stain, as a HEX value.
 	void									setColorGradient(float _fGradient); ///< Sets the stain's colour in the range of the gradient.
 	bool									isPointInside(float x, float y, bool fullRange); ///< Returns true if and only if the queried point is within the stain.
+	void									arePointsInside(const float* _xs, const float* _ys, int _nPoints, bool* _results); ///< Tests many [0;1] points at once against the stain.
 	bool									isPointClose(float x, float y, bool fullRange); ///< Returns true if and only if the queried point is close to the stain.
+	bool									getTouchBounds(ofRectangle& _bounds); ///< Gets the bounding box of the stain and of its grab areas, in [0;1] coordinates.
+	bool									hitTest(float x, float y); ///< Returns true if and only if a touch going down at these [0;1] coordinates grabs the stain.
 	int										getNumPointsInside(); ///< Returns the number of points within the stain.
+	const ofMesh&							getFillMesh(); ///< Returns the triangles that fill the stain, in pixels relative to the origin.
+	const ofMesh&							getOutlineMesh(); ///< Returns the polygon of the vertices, in pixels relative to the origin.
+	const ofMesh&							getHandlesMesh(bool _bDragged); ///< Returns the circles of the dragged (or other) vertices, in pixels relative to the origin.
+	int										getMeshRebuildCount(); ///< Returns the number of times the meshes were rebuilt.
 	int										getTimeSinceFirstFinger(); ///< Returns the time passed since the first finger hit the stain.
 	void									mouseDragged(int x, int y, int button); ///< Regular OpenFrameworks function.
 	void									mousePressed(int x, int y, int button); ///< Regular OpenFrameworks function.
@@ -83,6 +108,7 @@ public:
 	void									touchDown(float x, float y, int touchId); ///< Regular OpenFrameworks function.
 	void									touchMoved(float x, float y, int touchId); ///< Regular OpenFrameworks function.
 	void									touchUp(float x, float y, int touchId); ///< Regular OpenFrameworks function.
+	void									touchBatch(ofxTactoTouchBatchEventArgs& _args); ///< Handles all the touch changes of a frame (see \link ofxTactoHandler::touchBatch).
 
 private:
 	unsigned long int						m_nCounter; ///< A counter for dynamic features
@@ -103,6 +129,7 @@ private:
 	int										m_nColor2; ///< The end gradient color of the shape (see setColorGradient)
 	int										m_nCurrentColor; ///< The current color of the shape
 	int                						m_nNumVertices; ///< The number of vertices in the stain
+	int										m_nSetupVertices; ///< The number of vertices the stain was set up with (see reset())
 	int										m_nTimeFirstFinger; ///< Time (ms) at which the first finger landed on the stain
 
 	bool									m_bActive; ///< Is the shape active? (do not draw or interact with the shape until it is)
@@ -110,13 +137,61 @@ private:
 	bool									m_bMovable; ///< Whether or not the stain can be moved
 	bool									m_bScalable; ///< Whether or not the stain can be scaled and rotated
 	bool									m_bShapable; ///< Whether or not the stain can be shaped
+	bool									m_bAdaptive; ///< Whether or not the stain adapts its number of vertices to its outline
+	bool									m_bResolutionDirty; ///< Whether or not the vertices changed since the resolution was adapted
+	float									m_fMaxEdge; ///< The length beyond which an edge is split, in [0;1] units
+	float									m_fFlatAngle; ///< The deviation from 180 degrees under which a vertex is removed
 
-	ofxTactoVertex							vertices[VERTICES_MAX]; ///< An ofxTactoStain is nothing but an array of vertices!
+	ofxTactoSmallArray<ofxTactoVertex, STAIN_INLINE_VERTICES> vertices; ///< An ofxTactoStain is nothing but an array of vertices!
+	bool									m_bBoundsDirty; ///< Whether or not the vertices changed since the bounds were computed
+	float									m_fBoundsMinX; ///< The smallest x of the vertices, relative to the origin
+	float									m_fBoundsMinY; ///< The smallest y of the vertices, relative to the origin
+	float									m_fBoundsMaxX; ///< The largest x of the vertices, relative to the origin
+	float									m_fBoundsMaxY; ///< The largest y of the vertices, relative to the origin
+	float									m_fBoundsRadius; ///< The radius of the circle around the origin that holds all the vertices
+	float									m_fBoundsRadiusSq; ///< The squared radius of the circle around the origin that holds all the vertices
+	bool									m_bShapeDirty; ///< Whether or not a vertex moved since the area and angle terms were computed
+	ofxTactoSmallArray<bool, STAIN_INLINE_VERTICES> m_vertexDirty; ///< For each vertex, whether or not it moved since the terms were computed
+	ofxTactoSmallArray<float, STAIN_INLINE_VERTICES> m_areaTerms; ///< For each vertex i, the area term of the edge from i to i+1
+	ofxTactoSmallArray<float, STAIN_INLINE_VERTICES> m_angleTerms; ///< For each vertex, its internal angle in degrees
+	float									m_fAreaSum; ///< The sum of the area terms
+	float									m_fAngleSum; ///< The sum of the internal angles, in degrees
+	bool									m_bMeshDirty; ///< Whether or not the meshes must be rebuilt
+	int										m_nMeshWidth; ///< The window width for which the meshes were built
+	int										m_nMeshHeight; ///< The window height for which the meshes were built
+	int										m_nMeshRebuilds; ///< The number of times the meshes were rebuilt
+	ofPolyline								m_curve; ///< The tessellated Catmull-Rom outline, in pixels relative to the origin
+	ofTessellator							m_tessellator; ///< Turns the outline into triangles
+	ofVboMesh								m_fillMesh; ///< The triangles that fill the stain
+	ofVboMesh								m_outlineMesh; ///< The polygon of the vertices
+	ofVboMesh								m_draggedHandlesMesh; ///< The filled circles of the dragged vertices
+	ofVboMesh								m_handlesMesh; ///< The outlined circles of the other vertices
+	ofxTactoSmallArray<float, STAIN_INLINE_VERTICES> m_vertexXs; ///< The x of the vertices, relative to the origin and padded with NaN (see TactoGeometry)
+	ofxTactoSmallArray<float, STAIN_INLINE_VERTICES> m_vertexYs; ///< The y of the vertices, relative to the origin and padded with NaN
+	ofxTactoSmallArray<float, STAIN_INLINE_VERTICES> m_prevVertexXs; ///< The x of the previous vertex of each vertex, padded with NaN
+	ofxTactoSmallArray<float, STAIN_INLINE_VERTICES> m_prevVertexYs; ///< The y of the previous vertex of each vertex, padded with NaN
 	ofPoint									m_PtMotionStart; ///< Point at which the motion was started
 	ofPoint									m_PtMotionOrigin; ///< Origin point when the motion was started
 	std::list<ofxTactoBlobMovementInfo>		blobsInsideStain; ///< List of touch IDs inside the shape at any time (for manipulation)
 	std::string								m_sNameInfo; ///< The string to be displayed on the stain
+	int										m_nLabelPrecision; ///< The number of decimals of the values in the label
+	int										m_nLabelThrottle; ///< The shortest time (ms) between two updates of the label
+	unsigned long long						m_nLabelTime; ///< The time (ms) of the last update of the label
+	bool									m_bLabelValid; ///< Whether or not the label was laid out at least once
+	double									m_labelValues[4]; ///< The values shown in the label (origin, spikiness, area), rounded to its precision
+	static unsigned int						s_nLabelRebuilds; ///< The number of label layouts rebuilt by all the stains
 
+	void									setNumVertices(int _nVertices); ///< Resizes the vertices and the data that follows them.
+	void									adaptResolution(); ///< Splits the stretched edges and removes the flat vertices, if the stain is adaptive.
+	void									vertexMoved(int _nVertex); ///< Invalidates what depends on one vertex.
+	void									shapeChanged(); ///< Invalidates what depends on all the vertices.
+	void									updateShapeTerms(); ///< Recomputes the area and angle terms of the vertices that moved, and their sums.
+	float									areaTerm(int _nVertex); ///< Returns the area term of the edge that starts at a vertex.
+	float									angleTerm(int _nVertex); ///< Returns the internal angle at a vertex, in degrees.
+	void									updateLabel(); ///< Lays the label out again, if the values it shows changed.
+	void									updateMeshes(); ///< Rebuilds the meshes, if the shape or the window changed.
+	void									updateBounds(); ///< Recomputes the bounding box and circle and the vertex arrays, if the vertices changed.
+	int										grabbableVertex(float x, float y); ///< Returns the first vertex close enough to the [0;1] point to be grabbed, or -1.
 	float									polygonInternalAngles(); ///< Returns the sum of all internal angles of the stain, in degrees.
 	static float							angleBetweenVectors(float _ax, float _ay, float _bx, float _by); ///< Static function that returns the angle between two vectors.
 };
@@ -0,0 +1,204 @@
+#include "UI/ofxTactoStainBatch.h"
+#include "ofxTactoLatencyMonitor.h"
+
+ofxTactoStainBatch::ofxTactoStainBatch()
+{
+	m_nNumStains = 0;
+	m_nNumFlushes = 0;
+	m_triangles.setMode(OF_PRIMITIVE_TRIANGLES);
+	m_lines.setMode(OF_PRIMITIVE_LINES);
+}
+
+void ofxTactoStainBatch::begin()
+{
+	m_triangles.clear();
+	m_lines.clear();
+	m_stains.clear();
+	m_bounds.clear();
+	m_nNumStains = 0;
+	m_nNumFlushes = 0;
+}
+
+/** \note If the stain overlaps a pending stain, the pending stains are drawn first, so that the
+* stain is drawn over them as with ofxTactoStain::draw().
+* \param _stain The stain to draw.
+*/
+void ofxTactoStainBatch::add(ofxTactoStain& _stain)
+{
+	if (!_stain.isActive())
+		return;
+
+	ofPoint origin = _stain.getOrigin();
+	ofVec3f offset(origin.x * ofGetWidth(), origin.y * ofGetHeight(), 0);
+	ofRectangle bounds(offset.x, offset.y, 0, 0);
+	extendBounds(bounds, _stain.getFillMesh(), offset);
+	extendBounds(bounds, _stain.getOutlineMesh(), offset);
+	extendBounds(bounds, _stain.getHandlesMesh(true), offset);
+	extendBounds(bounds, _stain.getHandlesMesh(false), offset);
+	if (!m_bounds.empty() && overlap(bounds, m_unionBounds))
+	{
+		for (unsigned int i = 0; i < m_bounds.size(); i++)
+		{
+			if (overlap(bounds, m_bounds[i]))
+			{
+				flush();
+				break;
+			}
+		}
+	}
+
+	// The same colours as ofxTactoStain::draw()
+	appendMesh(m_triangles, _stain.getFillMesh(), offset, ofColor::fromHex(_stain.getCurrentColor()));
+	appendMesh(m_triangles, _stain.getHandlesMesh(true), offset, ofColor(0, 0, 0, 80));
+	appendMesh(m_lines, _stain.getOutlineMesh(), offset, ofColor(0, 0, 128, 40));
+	appendMesh(m_lines, _stain.getHandlesMesh(false), offset, ofColor(0, 0, 0, 80));
+	m_stains.push_back(&_stain);
+	if (m_bounds.empty())
+	{
+		m_unionBounds = bounds;
+	}
+	else
+	{
+		float fMinX = min(m_unionBounds.x, bounds.x);
+		float fMinY = min(m_unionBounds.y, bounds.y);
+		float fMaxX = max(m_unionBounds.x + m_unionBounds.width, bounds.x + bounds.width);
+		float fMaxY = max(m_unionBounds.y + m_unionBounds.height, bounds.y + bounds.height);
+		m_unionBounds.set(fMinX, fMinY, fMaxX - fMinX, fMaxY - fMinY);
+	}
+	m_bounds.push_back(bounds);
+	m_nNumStains++;
+}
+
+void ofxTactoStainBatch::end()
+{
+	flush();
+}
+
+/** \note Triangles keep the order in which the stains were added, and the lines are drawn over
+* them; this matches draw() since the pending stains do not overlap.
+*/
+void ofxTactoStainBatch::flush()
+{
+	if (m_stains.empty())
+		return;
+
+	ofxTactoLatencyMonitor::get().mark(TACTO_LATENCY_DRAW);
+	ofSetColor(255);
+	m_triangles.draw();
+	m_lines.draw();
+	for (unsigned int i = 0; i < m_stains.size(); i++)
+	{
+		m_stains[i]->drawLabel();
+	}
+	m_triangles.clear();
+	m_lines.clear();
+	m_stains.clear();
+	m_bounds.clear();
+	m_nNumFlushes++;
+}
+
+/** \param _stains The stains.
+* \param _nStains The number of stains.
+*/
+void ofxTactoStainBatch::draw(ofxTactoStain* _stains, int _nStains)
+{
+	begin();
+	for (int i = 0; i < _nStains; i++)
+	{
+		add(_stains[i]);
+	}
+	end();
+}
+
+/** \return The triangles of the stains added since the last flush(), with their colours.
+*/
+const ofMesh& ofxTactoStainBatch::getTriangles()
+{
+	return m_triangles;
+}
+
+/** \return The lines of the stains added since the last flush(), with their colours.
+*/
+const ofMesh& ofxTactoStainBatch::getLines()
+{
+	return m_lines;
+}
+
+/** \return The number of stains added since begin().
+*/
+int ofxTactoStainBatch::getNumStains()
+{
+	return m_nNumStains;
+}
+
+/** \note A batch of stains that do not overlap is drawn once.
+* \return The number of times the batch was drawn since begin().
+*/
+int ofxTactoStainBatch::getNumFlushes()
+{
+	return m_nNumFlushes;
+}
+
+/** \note Indexed meshes are expanded, and line loops are turned into separate lines, so that
+* the primitives of every stain can share the same mesh.
+* \param _target The shared mesh (triangles or lines).
+* \param _source The mesh of a stain.
+* \param _offset The translation to apply, in pixels.
+* \param _color The colour of the primitives.
+*/
+void ofxTactoStainBatch::appendMesh(ofMesh& _target, const ofMesh& _source, const ofVec3f& _offset, const ofFloatColor& _color)
+{
+	int nVertices = _source.getNumVertices();
+	if (_source.getMode() == OF_PRIMITIVE_LINE_LOOP)
+	{
+		for (int i = 0; i < nVertices; i++)
+		{
+			_target.addVertex(_source.getVertex(i) + _offset);
+			_target.addVertex(_source.getVertex(i + 1 < nVertices ? i + 1 : 0) + _offset);
+			_target.addColor(_color);
+			_target.addColor(_color);
+		}
+		return;
+	}
+
+	int nIndices = _source.getNumIndices();
+	int nCorners = nIndices > 0 ? nIndices : nVertices;
+	for (int i = 0; i < nCorners; i++)
+	{
+		_target.addVertex(_source.getVertex(nIndices > 0 ? _source.getIndex(i) : i) + _offset);
+		_target.addColor(_color);
+	}
+}
+
+/** \param _bounds The bounding box to grow, in pixels.
+* \param _source The mesh of a stain.
+* \param _offset The translation of the mesh, in pixels.
+*/
+void ofxTactoStainBatch::extendBounds(ofRectangle& _bounds, const ofMesh& _source, const ofVec3f& _offset)
+{
+	float fMinX = _bounds.x;
+	float fMinY = _bounds.y;
+	float fMaxX = _bounds.x + _bounds.width;
+	float fMaxY = _bounds.y + _bounds.height;
+	int nVertices = _source.getNumVertices();
+	for (int i = 0; i < nVertices; i++)
+	{
+		ofVec3f vertex = _source.getVertex(i) + _offset;
+		fMinX = min(fMinX, vertex.x);
+		fMinY = min(fMinY, vertex.y);
+		fMaxX = max(fMaxX, vertex.x);
+		fMaxY = max(fMaxY, vertex.y);
+	}
+	_bounds.set(fMinX, fMinY, fMaxX - fMinX, fMaxY - fMinY);
+}
+
+/** \note Boxes that only touch overlap, since the line of an outline can cover both.
+* \param _a A bounding box.
+* \param _b Another bounding box.
+* \return Whether or not the two boxes overlap.
+*/
+bool ofxTactoStainBatch::overlap(const ofRectangle& _a, const ofRectangle& _b)
+{
+	return _a.x <= _b.x + _b.width && _b.x <= _a.x + _a.width
+		&& _a.y <= _b.y + _b.height && _b.y <= _a.y + _a.height;
+}
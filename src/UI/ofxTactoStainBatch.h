@@ -0,0 +1,58 @@
+#ifndef OFXTACTOSTAINBATCH_H
+#define OFXTACTOSTAINBATCH_H
+
+/**
+* \class ofxTactoStainBatch
+*
+* \brief A class that draws many stains with a couple of draw calls.
+*
+* Between begin() and end(), add() copies the cached meshes of each stain (see
+* \link ofxTactoStain::getFillMesh) into two shared meshes with per-vertex colours, translated to
+* the origin of the stain: one of triangles (fills and dragged handles) and one of lines (outlines
+* and other handles). end() submits both, then draws the labels.
+*
+* The stains keep the stacking order of their own draw(): when the bounds of a stain overlap those
+* of a stain already in the batch, add() first draws the pending batch (see flush()), so that the
+* later stain covers the earlier one. Stains that do not overlap share the same draw calls.
+*
+* The shared meshes keep their capacity from one frame to the next, so a batch of stains whose
+* shapes did not change allocates no memory.
+*
+* \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+*
+*/
+
+#include "ofMain.h"
+#include "UI/ofxTactoStain.h"
+
+/// A class that draws stains in batches.
+class ofxTactoStainBatch
+{
+public:
+	ofxTactoStainBatch(); ///< Constructor
+
+	void									begin(); ///< Starts a new batch.
+	void									add(ofxTactoStain& _stain); ///< Adds a stain to the batch (inactive stains are skipped).
+	void									end(); ///< Draws the batch.
+	void									flush(); ///< Draws the pending stains of the batch and empties it.
+	void									draw(ofxTactoStain* _stains, int _nStains); ///< Draws an array of stains as one batch.
+	const ofMesh&							getTriangles(); ///< Returns the triangles of the pending stains, in pixels.
+	const ofMesh&							getLines(); ///< Returns the lines of the pending stains, in pixels.
+	int										getNumStains(); ///< Returns the number of stains added since begin().
+	int										getNumFlushes(); ///< Returns the number of times the batch was drawn since begin().
+
+private:
+	static void								appendMesh(ofMesh& _target, const ofMesh& _source, const ofVec3f& _offset, const ofFloatColor& _color); ///< Appends translated and coloured primitives to a shared mesh.
+	static void								extendBounds(ofRectangle& _bounds, const ofMesh& _source, const ofVec3f& _offset); ///< Grows a bounding box to hold the vertices of a mesh.
+	static bool								overlap(const ofRectangle& _a, const ofRectangle& _b); ///< Returns whether or not two bounding boxes overlap.
+
+	ofVboMesh								m_triangles; ///< The fills and dragged handles of the batch.
+	ofVboMesh								m_lines; ///< The outlines and other handles of the batch.
+	vector<ofxTactoStain*>					m_stains; ///< The pending stains of the batch, for their labels.
+	vector<ofRectangle>						m_bounds; ///< The bounding boxes of the pending stains, in pixels.
+	ofRectangle								m_unionBounds; ///< The bounding box of all the pending stains, in pixels.
+	int										m_nNumStains; ///< The number of stains added since begin().
+	int										m_nNumFlushes; ///< The number of times the batch was drawn since begin().
+};
+
+#endif // OFXTACTOSTAINBATCH_H
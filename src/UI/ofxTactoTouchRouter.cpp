@@ -0,0 +1,193 @@
+#include "UI/ofxTactoTouchRouter.h"
+
+ofxTactoTouchRouter::ofxTactoTouchRouter() : m_bDirty(true)
+{
+	m_cellStarts.assign(TOUCHROUTER_GRID_SIZE * TOUCHROUTER_GRID_SIZE + 1, 0);
+}
+
+/** \note The router does not own the widget. Widgets are tested in the order in which they were added.
+* \param _target The widget.
+*/
+void ofxTactoTouchRouter::addTarget(ofxTactoTouchTarget* _target)
+{
+	m_targets.push_back(_target);
+	m_bDirty = true;
+}
+
+/** \note The touches that the widget captured are released without a touchUp().
+* \param _target The widget.
+*/
+void ofxTactoTouchRouter::removeTarget(ofxTactoTouchTarget* _target)
+{
+	m_targets.erase(std::remove(m_targets.begin(), m_targets.end(), _target), m_targets.end());
+	for (int i = m_captures.size() - 1; i >= 0; i--)
+	{
+		if (m_captures[i].target == _target)
+		{
+			m_captures[i] = m_captures.back();
+			m_captures.pop_back();
+		}
+	}
+	m_bDirty = true;
+}
+
+/** \return The number of registered widgets.
+*/
+int ofxTactoTouchRouter::getNumTargets()
+{
+	return m_targets.size();
+}
+
+/** \note Call it once per frame, before dispatching touches one by one, since widgets move and
+* change shape. touchBatch() does it already.
+*/
+void ofxTactoTouchRouter::rebuild()
+{
+	int nTargets = m_targets.size();
+	m_targetCells.resize(nTargets * 4);
+	std::fill(m_cellStarts.begin(), m_cellStarts.end(), 0);
+
+	// Count the widgets of each cell
+	int nEntries = 0;
+	for (int i = 0; i < nTargets; i++)
+	{
+		int* cells = &m_targetCells[i * 4];
+		ofRectangle bounds;
+		if (!m_targets[i]->getTouchBounds(bounds))
+		{
+			cells[0] = -1;
+			continue;
+		}
+		cells[0] = cellOf(bounds.x);
+		cells[1] = cellOf(bounds.y);
+		cells[2] = cellOf(bounds.x + bounds.width);
+		cells[3] = cellOf(bounds.y + bounds.height);
+		for (int row = cells[1]; row <= cells[3]; row++)
+		{
+			for (int col = cells[0]; col <= cells[2]; col++)
+			{
+				m_cellStarts[row * TOUCHROUTER_GRID_SIZE + col + 1]++;
+			}
+		}
+		nEntries += (cells[2] - cells[0] + 1) * (cells[3] - cells[1] + 1);
+	}
+
+	// Turn the counts into offsets, then fill the cells in the order of the widgets
+	for (int i = 1; i < (int)m_cellStarts.size(); i++)
+	{
+		m_cellStarts[i] += m_cellStarts[i - 1];
+	}
+	m_cellTargets.resize(nEntries);
+	for (int i = 0; i < nTargets; i++)
+	{
+		const int* cells = &m_targetCells[i * 4];
+		if (cells[0] < 0)
+			continue;
+		for (int row = cells[1]; row <= cells[3]; row++)
+		{
+			for (int col = cells[0]; col <= cells[2]; col++)
+			{
+				// m_cellStarts[cell] is used as the insertion point, and ends up at the start of the next cell
+				m_cellTargets[m_cellStarts[row * TOUCHROUTER_GRID_SIZE + col]++] = i;
+			}
+		}
+	}
+	for (int i = m_cellStarts.size() - 1; i > 0; i--)
+	{
+		m_cellStarts[i] = m_cellStarts[i - 1];
+	}
+	m_cellStarts[0] = 0;
+	m_bDirty = false;
+}
+
+/**
+* \param x The x coordinate of the touch event, in [0;1].
+* \param y The y coordinate of the touch event, in [0;1].
+* \param touchId The ID of the touch point.
+*/
+void ofxTactoTouchRouter::touchDown(float x, float y, int touchId)
+{
+	if (m_bDirty)
+		rebuild();
+
+	int cell = cellOf(y) * TOUCHROUTER_GRID_SIZE + cellOf(x);
+	for (int i = m_cellStarts[cell]; i < m_cellStarts[cell + 1]; i++)
+	{
+		ofxTactoTouchTarget* target = m_targets[m_cellTargets[i]];
+		if (target->hitTest(x, y))
+		{
+			capture newCapture = { touchId, target };
+			m_captures.push_back(newCapture);
+			target->touchDown(x, y, touchId);
+		}
+	}
+}
+
+/**
+* \param x The x coordinate of the touch event, in [0;1].
+* \param y The y coordinate of the touch event, in [0;1].
+* \param touchId The ID of the touch point.
+*/
+void ofxTactoTouchRouter::touchMoved(float x, float y, int touchId)
+{
+	for (unsigned int i = 0; i < m_captures.size(); i++)
+	{
+		if (m_captures[i].touchId == touchId)
+			m_captures[i].target->touchMoved(x, y, touchId);
+	}
+}
+
+/**
+* \param x The x coordinate of the touch event, in [0;1].
+* \param y The y coordinate of the touch event, in [0;1].
+* \param touchId The ID of the touch point.
+*/
+void ofxTactoTouchRouter::touchUp(float x, float y, int touchId)
+{
+	for (int i = m_captures.size() - 1; i >= 0; i--)
+	{
+		if (m_captures[i].touchId == touchId)
+		{
+			ofxTactoTouchTarget* target = m_captures[i].target;
+			m_captures[i] = m_captures.back();
+			m_captures.pop_back();
+			target->touchUp(x, y, touchId);
+		}
+	}
+}
+
+/** \note Register with ofAddListener(handler.touchBatch, &router, &ofxTactoTouchRouter::touchBatch),
+* and do not forward the same touches to the widgets otherwise.
+* \param _args The touch changes of the frame.
+*/
+void ofxTactoTouchRouter::touchBatch(ofxTactoTouchBatchEventArgs& _args)
+{
+	rebuild();
+	for (int i = 0; i < _args.numEvents; i++)
+	{
+		const ofxTactoTouchEvent& event = _args.events[i];
+		switch (event.type)
+		{
+			case TACTO_TOUCH_DOWN:
+				touchDown(event.x, event.y, event.id);
+				break;
+			case TACTO_TOUCH_MOVED:
+				touchMoved(event.x, event.y, event.id);
+				break;
+			case TACTO_TOUCH_UP:
+				touchUp(event.x, event.y, event.id);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/** \param _fCoord A coordinate, in [0;1] (clamped otherwise).
+* \return The column or row of the grid that holds the coordinate.
+*/
+int ofxTactoTouchRouter::cellOf(float _fCoord)
+{
+	int cell = (int)(_fCoord * TOUCHROUTER_GRID_SIZE);
+	return cell < 0 ? 0 : (cell >= TOUCHROUTER_GRID_SIZE ? TOUCHROUTER_GRID_SIZE - 1 : cell);
+}
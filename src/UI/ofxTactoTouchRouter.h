@@ -0,0 +1,60 @@
+#ifndef _OF_TACTO_TOUCHROUTER
+#define _OF_TACTO_TOUCHROUTER
+
+/**
+ * \class ofxTactoTouchRouter
+ *
+ * \brief A class that dispatches touches to the widgets under them only.
+ *
+ * Instead of every widget receiving every touch and running its own hit test, the widgets
+ * (\link ofxTactoTouchTarget) are registered with a router, which indexes their bounding boxes in
+ * a uniform grid over the screen. A touch that goes down is only tested against the widgets
+ * whose boxes overlap its grid cell, and it is captured by those that accept it: its moves and
+ * its lift then go to them directly, without any search.
+ *
+ * The grid is rebuilt from the current bounds of the widgets by rebuild(), which touchBatch()
+ * calls before each frame. Once the buffers are warmed up, routing allocates no memory.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxTactoTouchEvent.h"
+#include "UI/ofxTactoTouchTarget.h"
+
+#define TOUCHROUTER_GRID_SIZE 16 ///< The number of grid cells along each axis.
+
+/// A class that routes touches to widgets.
+class ofxTactoTouchRouter
+{
+public:
+	ofxTactoTouchRouter(); ///< Constructor
+
+	void									addTarget(ofxTactoTouchTarget* _target); ///< Registers a widget.
+	void									removeTarget(ofxTactoTouchTarget* _target); ///< Unregisters a widget.
+	int										getNumTargets(); ///< Returns the number of registered widgets.
+	void									rebuild(); ///< Indexes the current bounds of the widgets.
+	void									touchDown(float x, float y, int touchId); ///< Dispatches a new touch to the widgets under it.
+	void									touchMoved(float x, float y, int touchId); ///< Dispatches a move to the widgets that captured the touch.
+	void									touchUp(float x, float y, int touchId); ///< Dispatches a lift to the widgets that captured the touch, and releases it.
+	void									touchBatch(ofxTactoTouchBatchEventArgs& _args); ///< Rebuilds the index and dispatches all the touch changes of a frame.
+
+private:
+	/// A touch captured by a widget.
+	struct capture {
+		int touchId; ///< The ID of the touch.
+		ofxTactoTouchTarget* target; ///< The widget that captured it.
+	};
+
+	static int								cellOf(float _fCoord); ///< Returns the grid column or row of a coordinate.
+
+	vector<ofxTactoTouchTarget*>			m_targets; ///< The registered widgets.
+	vector<int>								m_cellStarts; ///< For each cell, the position of its first widget in m_cellTargets (one more entry marks the end).
+	vector<int>								m_cellTargets; ///< The widgets of each cell, packed cell by cell.
+	vector<int>								m_targetCells; ///< For each widget, its cell range (first column, first row, last column, last row), or -1 when it takes no touch.
+	vector<capture>							m_captures; ///< The touches currently captured.
+	bool									m_bDirty; ///< Whether or not the widgets changed since the last rebuild.
+};
+
+#endif
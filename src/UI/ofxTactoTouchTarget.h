@@ -0,0 +1,31 @@
+#ifndef _OF_TACTO_TOUCHTARGET
+#define _OF_TACTO_TOUCHTARGET
+
+/**
+ * \class ofxTactoTouchTarget
+ *
+ * \brief The interface of the widgets to which an \link ofxTactoTouchRouter dispatches touches.
+ *
+ * A target reports a bounding box in [0;1] coordinates, which must contain every point at which
+ * a touch could start an interaction with it, and a precise hit test. Once a touch went down on
+ * a target, the target receives the moves and the lift of that touch, wherever they happen.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include "ofMain.h"
+
+/// The interface of touch-enabled widgets.
+class ofxTactoTouchTarget
+{
+public:
+	virtual ~ofxTactoTouchTarget() {} ///< Destructor
+	virtual bool							getTouchBounds(ofRectangle& _bounds) = 0; ///< Gets the bounding box of the widget, in [0;1] coordinates. Returns false if the widget takes no touch.
+	virtual bool							hitTest(float /*x*/, float /*y*/) { return true; } ///< Returns true if and only if a touch going down at these [0;1] coordinates is for the widget.
+	virtual void							touchDown(float x, float y, int touchId) = 0; ///< Regular OpenFrameworks function.
+	virtual void							touchMoved(float /*x*/, float /*y*/, int /*touchId*/) {} ///< Regular OpenFrameworks function.
+	virtual void							touchUp(float /*x*/, float /*y*/, int /*touchId*/) {} ///< Regular OpenFrameworks function.
+};
+
+#endif
@@ -19,6 +19,9 @@ ofxTactoBlob::ofxTactoBlob(int _id, float _x, float _y, float _vx, float _vy, fl
     width = _width;
     height = _height;
     accel = _accel;
+    classId = 0;
+    angle = 0;
+    rotationSpeed = 0;
 
     // Init to random color
     color.a = 255;
@@ -27,6 +30,14 @@ ofxTactoBlob::ofxTactoBlob(int _id, float _x, float _y, float _vx, float _vy, fl
     color.b = ofRandomuf() * 255;
 }
 
+/** \brief The default blob has ID 0, sits at the origin and is black. Unlike the other constructor,
+* it does not draw a random colour, so it is cheap to create.
+*/
+ofxTactoBlob::ofxTactoBlob() :
+    id(0), x(0), y(0), vx(0), vy(0), width(0), height(0), accel(0), classId(0), angle(0), rotationSpeed(0), color(0)
+{
+}
+
 void ofxTactoBlob::draw()
 {
     ofSetColor(color.r, color.g, color.b, color.a);
@@ -16,11 +16,16 @@
 
 #include "ofMain.h"
 
-/// A class that implements a multi-touch point of contact.
+/** \brief A class that implements a multi-touch point of contact.
+*
+* The touch system itself stores its blobs as separate arrays (see \link ofxTactoBlobTable);
+* ofxTactoBlob is the lightweight value through which one blob is read or copied.
+*/
 class ofxTactoBlob
 {
     public:
         ofxTactoBlob(int _id, float _x, float _y, float _vx, float _vy, float _width, float _height, float _accel); ///< Constructor
+        ofxTactoBlob(); ///< Default constructor
 		void            draw(); ///< Regular OpenFrameworks function.
 
         int             id; ///< The ID of the blob.
@@ -31,6 +36,9 @@ class ofxTactoBlob
         float           width; ///< The width of the blob.
         float           height; ///< The height of the blob.
         float           accel; ///< The acceleration of the blob.
+        int             classId; ///< The class (fiducial) ID of the blob, for TUIO objects.
+        float           angle; ///< The angle in radians of the blob, for TUIO objects and shapes.
+        float           rotationSpeed; ///< The rotation speed of the blob, for TUIO objects and shapes.
         ofColor         color; ///< The colour of the blob.
 };
 
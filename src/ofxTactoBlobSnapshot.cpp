@@ -0,0 +1,41 @@
+#include "ofxTactoBlobSnapshot.h"
+
+#define BLOBSNAPSHOT_INDEX_MASK 3
+#define BLOBSNAPSHOT_FRESH 4
+
+ofxTactoBlobSnapshot::ofxTactoBlobSnapshot() : m_nBack(0), m_nFront(1), m_nMiddle(2)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        m_buffers[i].reserve(BLOBSNAPSHOT_INITIAL_CAPACITY);
+    }
+}
+
+/** \return The buffer to fill with the blobs of the new snapshot.
+*/
+vector<ofxTactoBlob>& ofxTactoBlobSnapshot::beginWrite()
+{
+    m_buffers[m_nBack].clear();
+    return m_buffers[m_nBack];
+}
+
+void ofxTactoBlobSnapshot::publish()
+{
+    // Hand the filled buffer over and take back whichever one was in transit
+    int previous = m_nMiddle.exchange(m_nBack | BLOBSNAPSHOT_FRESH, std::memory_order_acq_rel);
+    m_nBack = previous & BLOBSNAPSHOT_INDEX_MASK;
+}
+
+/** \note The returned view stays valid until the next call to acquire().
+* \return A view over the latest published blobs.
+*/
+ofxTactoBlobView ofxTactoBlobSnapshot::acquire()
+{
+    if (m_nMiddle.load(std::memory_order_relaxed) & BLOBSNAPSHOT_FRESH)
+    {
+        int previous = m_nMiddle.exchange(m_nFront, std::memory_order_acq_rel);
+        m_nFront = previous & BLOBSNAPSHOT_INDEX_MASK;
+    }
+    const vector<ofxTactoBlob>& front = m_buffers[m_nFront];
+    return ofxTactoBlobView(front.empty() ? NULL : &front[0], front.size());
+}
@@ -0,0 +1,60 @@
+#ifndef TACTOBLOBSNAPSHOT_H
+#define TACTOBLOBSNAPSHOT_H
+
+/**
+ * \class ofxTactoBlobSnapshot
+ *
+ * \brief A snapshot of the blobs of the touch system that another thread can read without locks.
+ *
+ * The snapshot is a triple buffer: the writer (the thread that calls \link ofxTactoHandler::update())
+ * fills its back buffer and publishes it, and the reader (e.g. an audio mapping thread) picks up
+ * the latest published buffer with acquire(). The two threads exchange buffers with a single atomic
+ * operation, so neither ever waits for the other and the reader always sees a complete frame.
+ * There must be only one reader thread.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include <atomic>
+#include "ofMain.h"
+#include "ofxTactoBlob.h"
+
+#define BLOBSNAPSHOT_INITIAL_CAPACITY 128
+
+/// A class that gives read-only access to a contiguous array of blobs, without copying it.
+class ofxTactoBlobView
+{
+    public:
+        ofxTactoBlobView() : m_pBlobs(NULL), m_nSize(0) {} ///< Default constructor (empty view).
+        ofxTactoBlobView(const ofxTactoBlob* _pBlobs, int _nSize) : m_pBlobs(_pBlobs), m_nSize(_nSize) {} ///< Constructor
+
+        const ofxTactoBlob* begin() const { return m_pBlobs; } ///< Returns a pointer to the first blob.
+        const ofxTactoBlob* end() const { return m_pBlobs + m_nSize; } ///< Returns a pointer past the last blob.
+        int                 size() const { return m_nSize; } ///< Returns the number of blobs.
+        bool                empty() const { return m_nSize == 0; } ///< Returns true if and only if there are no blobs.
+        const ofxTactoBlob& operator[](int _n) const { return m_pBlobs[_n]; } ///< Returns the n-th blob.
+
+    private:
+        const ofxTactoBlob* m_pBlobs; ///< The first blob.
+        int                 m_nSize; ///< The number of blobs.
+};
+
+/// A class that implements a lock-free snapshot of the blobs for a single reader thread.
+class ofxTactoBlobSnapshot
+{
+    public:
+        ofxTactoBlobSnapshot(); ///< Constructor
+
+        vector<ofxTactoBlob>& beginWrite(); ///< Returns the (emptied) buffer to fill. Writer thread only.
+        void                publish(); ///< Makes the filled buffer the latest snapshot. Writer thread only.
+        ofxTactoBlobView    acquire(); ///< Returns the latest published snapshot. Reader thread only.
+
+    private:
+        vector<ofxTactoBlob> m_buffers[3]; ///< The three buffers.
+        int                 m_nBack; ///< The buffer owned by the writer.
+        int                 m_nFront; ///< The buffer owned by the reader.
+        std::atomic<int>    m_nMiddle; ///< The buffer in transit, with BLOBSNAPSHOT_FRESH set when it was published and not yet acquired.
+};
+
+#endif // TACTOBLOBSNAPSHOT_H
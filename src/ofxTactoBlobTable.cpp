@@ -0,0 +1,347 @@
+#include "ofxTactoBlobTable.h"
+
+ofxTactoBlobTable::ofxTactoBlobTable() : m_nGeneration(1), m_nFrame(1), m_nMask(0)
+{
+    rehash(BLOBTABLE_INITIAL_BUCKETS);
+}
+
+/** \param _id The ID of the blob.
+* \return The slot of the blob, or -1 if no blob has this ID.
+*/
+int ofxTactoBlobTable::find(int _id) const
+{
+    int bucket = findBucket(_id);
+    if (bucket < 0)
+        return -1;
+    return m_buckets[bucket];
+}
+
+/** \note If a blob with the same ID is already in the table, it is overwritten in place.
+* \param _blob The blob to insert.
+* \return The slot of the inserted blob.
+*/
+int ofxTactoBlobTable::insert(const ofxTactoBlob& _blob)
+{
+    int slot = find(_blob.id);
+    if (slot < 0)
+    {
+        // Keep the load factor under one half
+        if ((size() + 1) * 2 > (int)m_buckets.size())
+            rehash(m_buckets.size() * 2);
+
+        slot = allocateSlot();
+        m_ids[slot] = _blob.id;
+        // A new blob counts as alive in the generation it was inserted in
+        m_slotStamps[slot] = m_nGeneration;
+        m_slotFrames[slot] = 0;
+        m_slotDenseIndex[slot] = m_dense.size();
+        m_dense.push_back(slot);
+
+        int bucket = bucketOf(_blob.id);
+        while (m_buckets[bucket] != -1)
+            bucket = (bucket + 1) & m_nMask;
+        m_buckets[bucket] = slot;
+    }
+
+    set(slot, _blob.x, _blob.y, _blob.vx, _blob.vy, _blob.width, _blob.height, _blob.accel);
+    setOrientation(slot, _blob.classId, _blob.angle, _blob.rotationSpeed);
+    m_colors[slot] = _blob.color;
+    return slot;
+}
+
+/** \param _id The ID of the blob to remove.
+* \return Whether or not a blob was removed.
+*/
+bool ofxTactoBlobTable::erase(int _id)
+{
+    int bucket = findBucket(_id);
+    if (bucket < 0)
+        return false;
+    int slot = m_buckets[bucket];
+
+    // Backward-shift deletion keeps the probe sequences intact without tombstones
+    int hole = bucket;
+    int i = (bucket + 1) & m_nMask;
+    while (m_buckets[i] != -1)
+    {
+        int home = bucketOf(m_ids[m_buckets[i]]);
+        if (((i - home) & m_nMask) >= ((i - hole) & m_nMask))
+        {
+            m_buckets[hole] = m_buckets[i];
+            hole = i;
+        }
+        i = (i + 1) & m_nMask;
+    }
+    m_buckets[hole] = -1;
+
+    // Remove the slot from the dense list; the other slots do not move
+    int denseIndex = m_slotDenseIndex[slot];
+    int lastSlot = m_dense.back();
+    m_dense[denseIndex] = lastSlot;
+    m_slotDenseIndex[lastSlot] = denseIndex;
+    m_dense.pop_back();
+    m_slotDenseIndex[slot] = -1;
+    m_freeSlots.push_back(slot);
+    m_xs[slot] = m_ys[slot] = NAN;
+
+    return true;
+}
+
+void ofxTactoBlobTable::clear()
+{
+    for (int i = m_dense.size() - 1; i >= 0; i--)
+    {
+        int slot = m_dense[i];
+        m_slotDenseIndex[slot] = -1;
+        m_freeSlots.push_back(slot);
+        m_xs[slot] = m_ys[slot] = NAN;
+    }
+    m_dense.clear();
+    std::fill(m_buckets.begin(), m_buckets.end(), -1);
+}
+
+/** \return The number of blobs in the table.
+*/
+int ofxTactoBlobTable::size() const
+{
+    return m_dense.size();
+}
+
+/** \note Erasing a blob changes the dense order, so iterate backwards when erasing while iterating.
+* \param _n The dense index of the blob, in [0;size()[.
+* \return The slot of the n-th active blob.
+*/
+int ofxTactoBlobTable::slotAt(int _n) const
+{
+    return m_dense[_n];
+}
+
+/** \param _slot The slot of the blob.
+* \return A copy of the blob.
+*/
+ofxTactoBlob ofxTactoBlobTable::get(int _slot) const
+{
+    ofxTactoBlob blob;
+    blob.id = m_ids[_slot];
+    blob.x = m_xs[_slot];
+    blob.y = m_ys[_slot];
+    blob.vx = m_vxs[_slot];
+    blob.vy = m_vys[_slot];
+    blob.width = m_widths[_slot];
+    blob.height = m_heights[_slot];
+    blob.accel = m_accels[_slot];
+    blob.classId = m_classIds[_slot];
+    blob.angle = m_angles[_slot];
+    blob.rotationSpeed = m_rotationSpeeds[_slot];
+    blob.color = m_colors[_slot];
+    return blob;
+}
+
+/** \param _n The dense index of the blob, in [0;size()[.
+* \return A copy of the n-th active blob.
+*/
+ofxTactoBlob ofxTactoBlobTable::operator[](int _n) const
+{
+    return get(m_dense[_n]);
+}
+
+/** \param _slot The slot of the blob.
+* \param _x The x coordinate of the blob.
+* \param _y The y coordinate of the blob.
+* \param _vx The speed along axis x of the blob.
+* \param _vy The speed along axis y of the blob.
+* \param _width The width of the blob.
+* \param _height The height of the blob.
+* \param _accel The acceleration of the blob.
+*/
+void ofxTactoBlobTable::set(int _slot, float _x, float _y, float _vx, float _vy, float _width, float _height, float _accel)
+{
+    m_xs[_slot] = _x;
+    m_ys[_slot] = _y;
+    m_vxs[_slot] = _vx;
+    m_vys[_slot] = _vy;
+    m_widths[_slot] = _width;
+    m_heights[_slot] = _height;
+    m_accels[_slot] = _accel;
+}
+
+/** \param _slot The slot of the blob.
+* \param _x The x coordinate of the blob.
+* \param _y The y coordinate of the blob.
+*/
+void ofxTactoBlobTable::setPosition(int _slot, float _x, float _y)
+{
+    m_xs[_slot] = _x;
+    m_ys[_slot] = _y;
+}
+
+/** \param _slot The slot of the blob.
+* \param _classId The class (fiducial) ID of the blob.
+* \param _angle The angle in radians of the blob.
+* \param _rotationSpeed The rotation speed of the blob.
+*/
+void ofxTactoBlobTable::setOrientation(int _slot, int _classId, float _angle, float _rotationSpeed)
+{
+    m_classIds[_slot] = _classId;
+    m_angles[_slot] = _angle;
+    m_rotationSpeeds[_slot] = _rotationSpeed;
+}
+
+/** \return The number of slots, which is the length of every field array.
+*/
+int ofxTactoBlobTable::slotCount() const
+{
+    return m_ids.size();
+}
+
+/** \note This is a branch-free sweep over all the slots, which compilers can vectorize.
+* \param _x The x coordinate of the point.
+* \param _y The y coordinate of the point.
+* \param _fMaxDistance The largest distance at which a blob is considered.
+* \return The slot of the closest blob, or -1 if no blob is close enough.
+*/
+int ofxTactoBlobTable::closestSlot(float _x, float _y, float _fMaxDistance) const
+{
+    const float* xs = m_xs.data();
+    const float* ys = m_ys.data();
+    int nSlots = slotCount();
+    float bestDistSq = _fMaxDistance * _fMaxDistance;
+    int bestSlot = -1;
+    for (int i = 0; i < nSlots; i++)
+    {
+        float dx = xs[i] - _x;
+        float dy = ys[i] - _y;
+        float distSq = dx * dx + dy * dy;
+        // NaN (free slot) never compares smaller
+        bool closer = distSq < bestDistSq;
+        bestDistSq = closer ? distSq : bestDistSq;
+        bestSlot = closer ? i : bestSlot;
+    }
+    return bestSlot;
+}
+
+void ofxTactoBlobTable::beginMark()
+{
+    m_nGeneration++;
+    if (m_nGeneration == 0)
+    {
+        // The counter wrapped around, so old stamps could be mistaken for new ones
+        std::fill(m_slotStamps.begin(), m_slotStamps.end(), 0);
+        m_nGeneration = 1;
+    }
+}
+
+/** \param _id The ID of the blob.
+* \return Whether or not a blob with this ID is in the table.
+*/
+bool ofxTactoBlobTable::mark(int _id)
+{
+    int slot = find(_id);
+    if (slot < 0)
+        return false;
+    m_slotStamps[slot] = m_nGeneration;
+    return true;
+}
+
+/** \param _n The dense index of the blob, in [0;size()[.
+* \return Whether or not the blob was marked since the last call to beginMark().
+*/
+bool ofxTactoBlobTable::isMarked(int _n) const
+{
+    return m_slotStamps[m_dense[_n]] == m_nGeneration;
+}
+
+void ofxTactoBlobTable::beginFrame()
+{
+    m_nFrame++;
+    if (m_nFrame == 0)
+    {
+        std::fill(m_slotFrames.begin(), m_slotFrames.end(), 0);
+        m_nFrame = 1;
+    }
+}
+
+/** \param _id The ID of the blob.
+* \return True if the blob is in the table and had not been updated yet in the current frame.
+*/
+bool ofxTactoBlobTable::markUpdated(int _id)
+{
+    int slot = find(_id);
+    if (slot < 0)
+        return false;
+    if (m_slotFrames[slot] == m_nFrame)
+        return false;
+    m_slotFrames[slot] = m_nFrame;
+    return true;
+}
+
+/** \param _id The ID of the blob.
+* \return The bucket at which probing for the ID starts.
+*/
+int ofxTactoBlobTable::bucketOf(int _id) const
+{
+    // Fibonacci hashing spreads consecutive session IDs over the table
+    unsigned int hash = (unsigned int)_id * 2654435761u;
+    return (hash ^ (hash >> 16)) & m_nMask;
+}
+
+/** \param _id The ID of the blob.
+* \return The bucket that holds the blob, or -1 if it is not in the table.
+*/
+int ofxTactoBlobTable::findBucket(int _id) const
+{
+    int bucket = bucketOf(_id);
+    while (m_buckets[bucket] != -1)
+    {
+        if (m_ids[m_buckets[bucket]] == _id)
+            return bucket;
+        bucket = (bucket + 1) & m_nMask;
+    }
+    return -1;
+}
+
+/** \param _nBuckets The new number of buckets, which must be a power of two.
+*/
+void ofxTactoBlobTable::rehash(int _nBuckets)
+{
+    m_buckets.assign(_nBuckets, -1);
+    m_nMask = _nBuckets - 1;
+    for (unsigned int i = 0; i < m_dense.size(); i++)
+    {
+        int slot = m_dense[i];
+        int bucket = bucketOf(m_ids[slot]);
+        while (m_buckets[bucket] != -1)
+            bucket = (bucket + 1) & m_nMask;
+        m_buckets[bucket] = slot;
+    }
+}
+
+/** \return The index of a free slot.
+*/
+int ofxTactoBlobTable::allocateSlot()
+{
+    if (!m_freeSlots.empty())
+    {
+        int slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        return slot;
+    }
+
+    int slot = m_ids.size();
+    m_ids.push_back(0);
+    m_xs.push_back(NAN);
+    m_ys.push_back(NAN);
+    m_vxs.push_back(0);
+    m_vys.push_back(0);
+    m_widths.push_back(0);
+    m_heights.push_back(0);
+    m_accels.push_back(0);
+    m_classIds.push_back(0);
+    m_angles.push_back(0);
+    m_rotationSpeeds.push_back(0);
+    m_colors.push_back(ofColor());
+    m_slotDenseIndex.push_back(-1);
+    m_slotStamps.push_back(0);
+    m_slotFrames.push_back(0);
+    return slot;
+}
@@ -0,0 +1,106 @@
+#ifndef TACTOBLOBTABLE_H
+#define TACTOBLOBTABLE_H
+
+/**
+ * \class ofxTactoBlobTable
+ *
+ * \brief A store of multi-touch blobs indexed by their TUIO session ID.
+ *
+ * Blobs live in stable slots: a blob keeps the same slot index from the moment
+ * it is inserted until it is erased. Lookup, insertion and erasure are O(1) on average
+ * through an open-addressing hash table, and the active blobs can be iterated densely
+ * with size() and slotAt().
+ *
+ * The fields of the blobs are stored as a structure of arrays: one aligned array per field,
+ * indexed by slot, over [0;slotCount()[. Free slots hold NaN coordinates, so a sweep over all
+ * the slots needs no branch to skip them: every comparison against a free slot is false.
+ * Free slots are reused first, so slotCount() stays close to the peak number of blobs.
+ *
+ * The table also supports mark-and-sweep reconciliation against a TUIO "alive" set:
+ * beginMark() starts a new generation, mark() stamps the blobs that are still alive,
+ * and isMarked() tells which blobs were not stamped. No memory is allocated in the process.
+ * In the same way, beginFrame() and markUpdated() tell whether a blob was already updated
+ * during the current frame.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxTactoBlob.h"
+#include "TactosonixHelpers.h"
+
+#define BLOBTABLE_INITIAL_BUCKETS 256
+
+/// A class that stores the blobs of the touch system, keyed by session ID.
+class ofxTactoBlobTable
+{
+    public:
+        typedef vector<float, TactoHelpers::alignedAllocator<float> > FloatArray; ///< An aligned array of one field, indexed by slot.
+
+        ofxTactoBlobTable(); ///< Constructor
+
+        int                 find(int _id) const; ///< Returns the slot of the blob with the queried ID, or -1 if it is not in the table.
+        int                 insert(const ofxTactoBlob& _blob); ///< Inserts a blob and returns its slot.
+        bool                erase(int _id); ///< Removes the blob with the queried ID.
+        void                clear(); ///< Removes all the blobs.
+        int                 size() const; ///< Returns the number of blobs in the table.
+        int                 slotAt(int _n) const; ///< Returns the slot of the n-th active blob (dense iteration order).
+        ofxTactoBlob        get(int _slot) const; ///< Returns a copy of the blob in the queried slot.
+        ofxTactoBlob        operator[](int _n) const; ///< Returns a copy of the n-th active blob.
+        void                set(int _slot, float _x, float _y, float _vx, float _vy, float _width, float _height, float _accel); ///< Updates the blob in the queried slot.
+        void                setPosition(int _slot, float _x, float _y); ///< Moves the blob in the queried slot.
+        void                setOrientation(int _slot, int _classId, float _angle, float _rotationSpeed); ///< Updates the class and orientation of the blob in the queried slot.
+
+        int                 slotCount() const; ///< Returns the number of slots, free or not (the length of the field arrays).
+        const int*          ids() const { return m_ids.data(); } ///< Returns the IDs, by slot.
+        const float*        xs() const { return m_xs.data(); } ///< Returns the x coordinates, by slot (NaN for free slots).
+        const float*        ys() const { return m_ys.data(); } ///< Returns the y coordinates, by slot (NaN for free slots).
+        const float*        vxs() const { return m_vxs.data(); } ///< Returns the speeds along axis x, by slot.
+        const float*        vys() const { return m_vys.data(); } ///< Returns the speeds along axis y, by slot.
+        const float*        widths() const { return m_widths.data(); } ///< Returns the widths, by slot.
+        const float*        heights() const { return m_heights.data(); } ///< Returns the heights, by slot.
+        const float*        accels() const { return m_accels.data(); } ///< Returns the accelerations, by slot.
+        const int*          classIds() const { return m_classIds.data(); } ///< Returns the class IDs, by slot.
+        const float*        angles() const { return m_angles.data(); } ///< Returns the angles, by slot.
+        const float*        rotationSpeeds() const { return m_rotationSpeeds.data(); } ///< Returns the rotation speeds, by slot.
+        int                 closestSlot(float _x, float _y, float _fMaxDistance) const; ///< Returns the slot of the blob closest to a point, or -1 if none is within the distance.
+
+        void                beginMark(); ///< Starts a new marking generation, in which no blob is marked yet.
+        bool                mark(int _id); ///< Marks the blob with the queried ID as alive in the current generation.
+        bool                isMarked(int _n) const; ///< Returns true if and only if the n-th active blob was marked in the current generation.
+
+        void                beginFrame(); ///< Starts a new frame, in which no blob was updated yet.
+        bool                markUpdated(int _id); ///< Marks the blob as updated in the current frame. Returns true the first time only.
+
+    private:
+        int                 bucketOf(int _id) const; ///< Returns the home bucket of an ID.
+        int                 findBucket(int _id) const; ///< Returns the bucket holding the queried ID, or -1.
+        void                rehash(int _nBuckets); ///< Rebuilds the hash index with the given number of buckets.
+        int                 allocateSlot(); ///< Returns a free slot, growing the field arrays if needed.
+
+        vector<int>         m_ids; ///< The IDs, by slot.
+        FloatArray          m_xs; ///< The x coordinates, by slot.
+        FloatArray          m_ys; ///< The y coordinates, by slot.
+        FloatArray          m_vxs; ///< The speeds along axis x, by slot.
+        FloatArray          m_vys; ///< The speeds along axis y, by slot.
+        FloatArray          m_widths; ///< The widths, by slot.
+        FloatArray          m_heights; ///< The heights, by slot.
+        FloatArray          m_accels; ///< The accelerations, by slot.
+        vector<int>         m_classIds; ///< The class IDs, by slot.
+        FloatArray          m_angles; ///< The angles, by slot.
+        FloatArray          m_rotationSpeeds; ///< The rotation speeds, by slot.
+        vector<ofColor>     m_colors; ///< The colours, by slot.
+
+        vector<int>         m_slotDenseIndex; ///< For each slot, its position in m_dense (-1 when the slot is free).
+        vector<int>         m_dense; ///< The indices of the occupied slots, packed.
+        vector<int>         m_freeSlots; ///< The indices of the free slots, ready for reuse.
+        vector<int>         m_buckets; ///< Open-addressing hash index from ID to slot (-1 when empty).
+        vector<unsigned int> m_slotStamps; ///< For each slot, the generation in which it was last marked.
+        unsigned int        m_nGeneration; ///< The current marking generation.
+        vector<unsigned int> m_slotFrames; ///< For each slot, the frame in which it was last updated.
+        unsigned int        m_nFrame; ///< The current frame.
+        int                 m_nMask; ///< The bucket count minus one (the bucket count is a power of two).
+};
+
+#endif // TACTOBLOBTABLE_H
@@ -0,0 +1,130 @@
+#include "ofxTactoCursorFilter.h"
+
+ofxTactoCursorFilter::ofxTactoCursorFilter() :
+    m_bEnabled(false),
+    m_fMinCutoff(CURSORFILTER_DEFAULT_MINCUTOFF),
+    m_fBeta(CURSORFILTER_DEFAULT_BETA),
+    m_fDerivativeCutoff(CURSORFILTER_DEFAULT_DCUTOFF),
+    m_fPrediction(0)
+{
+}
+
+/** \param _bEnabled Whether or not the filter is applied.
+*/
+void ofxTactoCursorFilter::setEnabled(bool _bEnabled)
+{
+    m_bEnabled = _bEnabled;
+}
+
+/** \return Whether or not the filter is applied.
+*/
+bool ofxTactoCursorFilter::isEnabled() const
+{
+    return m_bEnabled;
+}
+
+/** \note Lower the minimum cutoff to remove more jitter at rest; raise beta to reduce the lag of fast motion.
+* \param _fMinCutoff The cutoff frequency at rest, in Hz.
+* \param _fBeta How fast the cutoff frequency rises with the speed (in Hz per unit of speed).
+* \param _fDerivativeCutoff The cutoff frequency of the speed, in Hz.
+*/
+void ofxTactoCursorFilter::setSmoothing(float _fMinCutoff, float _fBeta, float _fDerivativeCutoff)
+{
+    m_fMinCutoff = _fMinCutoff;
+    m_fBeta = _fBeta;
+    m_fDerivativeCutoff = _fDerivativeCutoff;
+}
+
+/** \note Set it close to the latency of the pipeline (tracker, network and display). Large values
+* overshoot when the finger stops.
+* \param _fMilliseconds How far ahead positions are predicted, in milliseconds (0 to disable).
+*/
+void ofxTactoCursorFilter::setPrediction(float _fMilliseconds)
+{
+    m_fPrediction = _fMilliseconds / 1000.0f;
+}
+
+/** \return How far ahead positions are predicted, in milliseconds.
+*/
+float ofxTactoCursorFilter::getPrediction() const
+{
+    return m_fPrediction * 1000.0f;
+}
+
+/** \param _slot The slot of the cursor in its table.
+* \param _x The x coordinate of the cursor.
+* \param _y The y coordinate of the cursor.
+* \param _vx The speed along axis x reported by the tracker.
+* \param _vy The speed along axis y reported by the tracker.
+* \param _nTime The time of the update, in microseconds.
+*/
+void ofxTactoCursorFilter::reset(int _slot, float _x, float _y, float _vx, float _vy, unsigned long long _nTime)
+{
+    cursorState& state = stateOf(_slot);
+    state.x = state.rawX = _x;
+    state.y = state.rawY = _y;
+    state.dx = _vx;
+    state.dy = _vy;
+    state.time = _nTime;
+}
+
+/** \note The speed reported by the tracker is used when there is one, since it is measured on the
+* tracker's clock and does not suffer from network jitter. Otherwise, the speed is derived from
+* the raw positions.
+* \param _slot The slot of the cursor in its table.
+* \param _x The x coordinate of the cursor, replaced by the filtered (and predicted) one.
+* \param _y The y coordinate of the cursor, replaced by the filtered (and predicted) one.
+* \param _vx The speed along axis x reported by the tracker.
+* \param _vy The speed along axis y reported by the tracker.
+* \param _nTime The time of the update, in microseconds.
+*/
+void ofxTactoCursorFilter::filter(int _slot, float& _x, float& _y, float _vx, float _vy, unsigned long long _nTime)
+{
+    cursorState& state = stateOf(_slot);
+    float period = _nTime > state.time ? (_nTime - state.time) / 1000000.0f : CURSORFILTER_DEFAULT_PERIOD;
+
+    // Filter the speed
+    float dx = _vx;
+    float dy = _vy;
+    if (dx == 0 && dy == 0)
+    {
+        dx = (_x - state.rawX) / period;
+        dy = (_y - state.rawY) / period;
+    }
+    float derivativeAlpha = smoothingFactor(m_fDerivativeCutoff, period);
+    state.dx += derivativeAlpha * (dx - state.dx);
+    state.dy += derivativeAlpha * (dy - state.dy);
+
+    // Filter the position, with a cutoff that rises with the speed
+    float speed = sqrt(state.dx * state.dx + state.dy * state.dy);
+    float alpha = smoothingFactor(m_fMinCutoff + m_fBeta * speed, period);
+    state.x += alpha * (_x - state.x);
+    state.y += alpha * (_y - state.y);
+    state.rawX = _x;
+    state.rawY = _y;
+    state.time = _nTime;
+
+    _x = state.x + state.dx * m_fPrediction;
+    _y = state.y + state.dy * m_fPrediction;
+}
+
+/** \param _fCutoff The cutoff frequency, in Hz.
+* \param _fPeriod The time since the last update, in seconds.
+* \return The weight of the new sample, in ]0;1].
+*/
+float ofxTactoCursorFilter::smoothingFactor(float _fCutoff, float _fPeriod)
+{
+    float tau = 1.0f / (TWO_PI * _fCutoff);
+    return 1.0f / (1.0f + tau / _fPeriod);
+}
+
+/** \param _slot The slot of the cursor in its table.
+* \return The filter state of the slot.
+*/
+ofxTactoCursorFilter::cursorState& ofxTactoCursorFilter::stateOf(int _slot)
+{
+    // Slots are reused, so this only grows while the table itself grows
+    if (_slot >= (int)m_states.size())
+        m_states.resize(_slot + 1);
+    return m_states[_slot];
+}
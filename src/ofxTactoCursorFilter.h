@@ -0,0 +1,66 @@
+#ifndef TACTOCURSORFILTER_H
+#define TACTOCURSORFILTER_H
+
+/**
+ * \class ofxTactoCursorFilter
+ *
+ * \brief A smoothing and prediction stage for the positions of tracked cursors.
+ *
+ * Each cursor goes through a One-Euro filter (Casiez et al., CHI 2012): a low-pass filter whose
+ * cutoff frequency rises with the speed of the cursor, so that jitter is removed when the finger
+ * rests and lag stays small when it moves. The filtered position can then be extrapolated a few
+ * milliseconds ahead along the filtered velocity, to hide the latency of the pipeline.
+ *
+ * The state of the cursors is kept by slot of the \link ofxTactoBlobTable, so it only grows when
+ * the table does, and filtering allocates no memory. The filter is disabled by default.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include "ofMain.h"
+
+#define CURSORFILTER_DEFAULT_MINCUTOFF 1.0f ///< Hz
+#define CURSORFILTER_DEFAULT_BETA 5.0f ///< For positions in [0;1]
+#define CURSORFILTER_DEFAULT_DCUTOFF 1.0f ///< Hz
+#define CURSORFILTER_DEFAULT_PERIOD 0.016f ///< Seconds, when two updates have the same time
+
+/// A class that smooths and predicts the positions of cursors.
+class ofxTactoCursorFilter
+{
+    public:
+        ofxTactoCursorFilter(); ///< Constructor
+
+        void                setEnabled(bool _bEnabled); ///< Enables or disables the filter.
+        bool                isEnabled() const; ///< Returns true if and only if the filter is enabled.
+        void                setSmoothing(float _fMinCutoff, float _fBeta, float _fDerivativeCutoff); ///< Sets the parameters of the One-Euro filter.
+        void                setPrediction(float _fMilliseconds); ///< Sets how far ahead positions are predicted.
+        float               getPrediction() const; ///< Returns how far ahead positions are predicted, in milliseconds.
+
+        void                reset(int _slot, float _x, float _y, float _vx, float _vy, unsigned long long _nTime); ///< Starts filtering a new cursor.
+        void                filter(int _slot, float& _x, float& _y, float _vx, float _vy, unsigned long long _nTime); ///< Filters the new position of a cursor, in place.
+
+    private:
+        /// The filter state of one cursor.
+        struct cursorState {
+            float x; ///< The filtered x coordinate, before prediction.
+            float y; ///< The filtered y coordinate, before prediction.
+            float dx; ///< The filtered speed along axis x.
+            float dy; ///< The filtered speed along axis y.
+            float rawX; ///< The last raw x coordinate.
+            float rawY; ///< The last raw y coordinate.
+            unsigned long long time; ///< The time of the last update, in microseconds.
+        };
+
+        static float        smoothingFactor(float _fCutoff, float _fPeriod); ///< Returns the smoothing factor of a low-pass filter.
+        cursorState&        stateOf(int _slot); ///< Returns the state of a slot, growing the states if needed.
+
+        bool                m_bEnabled; ///< Whether or not the filter is applied.
+        float               m_fMinCutoff; ///< The cutoff frequency at rest, in Hz.
+        float               m_fBeta; ///< How fast the cutoff frequency rises with the speed.
+        float               m_fDerivativeCutoff; ///< The cutoff frequency of the speed, in Hz.
+        float               m_fPrediction; ///< How far ahead positions are predicted, in seconds.
+        vector<cursorState> m_states; ///< The filter state of each cursor, by slot.
+};
+
+#endif // TACTOCURSORFILTER_H
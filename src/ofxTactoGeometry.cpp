@@ -0,0 +1,181 @@
+#include "ofxTactoGeometry.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace TactoGeometry
+{
+
+/** \note This is the crossing-number test of http://paulbourke.net/geometry/insidepoly/, with the
+* division replaced by a multiplication whose comparison flips with the sign of the edge's height.
+* \param _xs The x coordinates of the vertices.
+* \param _ys The y coordinates of the vertices.
+* \param _prevXs The x coordinates of the previous vertices.
+* \param _prevYs The y coordinates of the previous vertices.
+* \param _n The number of vertices.
+* \param _x The x coordinate of the point.
+* \param _y The y coordinate of the point.
+* \return Whether or not the point is inside the polygon.
+*/
+bool pointInPolygonScalar(const float* _xs, const float* _ys, const float* _prevXs, const float* _prevYs, int _n, float _x, float _y)
+{
+    bool inShape = false;
+    for (int i = 0; i < _n; i++)
+    {
+        float dy = _prevYs[i] - _ys[i];
+        float lhs = (_x - _xs[i]) * dy;
+        float rhs = (_prevXs[i] - _xs[i]) * (_y - _ys[i]);
+        bool crosses = (_ys[i] <= _y) != (_prevYs[i] <= _y);
+        if (crosses && (dy > 0 ? lhs < rhs : lhs > rhs))
+            inShape = !inShape;
+    }
+    return inShape;
+}
+
+/** \param _xs The x coordinates of the vertices (padded).
+* \param _ys The y coordinates of the vertices (padded).
+* \param _prevXs The x coordinates of the previous vertices (padded).
+* \param _prevYs The y coordinates of the previous vertices (padded).
+* \param _n The number of vertices.
+* \param _x The x coordinate of the point.
+* \param _y The y coordinate of the point.
+* \return Whether or not the point is inside the polygon.
+*/
+bool pointInPolygon(const float* _xs, const float* _ys, const float* _prevXs, const float* _prevYs, int _n, float _x, float _y)
+{
+#if defined(__SSE2__)
+    __m128 x = _mm_set1_ps(_x);
+    __m128 y = _mm_set1_ps(_y);
+    __m128 zero = _mm_setzero_ps();
+    int parity = 0;
+    for (int i = 0; i < _n; i += 4)
+    {
+        __m128 x0 = _mm_loadu_ps(_xs + i);
+        __m128 y0 = _mm_loadu_ps(_ys + i);
+        __m128 x1 = _mm_loadu_ps(_prevXs + i);
+        __m128 y1 = _mm_loadu_ps(_prevYs + i);
+        __m128 dy = _mm_sub_ps(y1, y0);
+        __m128 lhs = _mm_mul_ps(_mm_sub_ps(x, x0), dy);
+        __m128 rhs = _mm_mul_ps(_mm_sub_ps(x1, x0), _mm_sub_ps(y, y0));
+        // The edge straddles the horizontal line through the point (false for NaN padding)
+        __m128 crosses = _mm_xor_ps(_mm_cmple_ps(y0, y), _mm_cmple_ps(y1, y));
+        __m128 left = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(dy, zero), _mm_cmplt_ps(lhs, rhs)),
+                                _mm_and_ps(_mm_cmplt_ps(dy, zero), _mm_cmpgt_ps(lhs, rhs)));
+        parity ^= _mm_movemask_ps(_mm_and_ps(crosses, left));
+    }
+    // The point is inside if an odd number of edges were crossed
+    return ((parity ^ (parity >> 1) ^ (parity >> 2) ^ (parity >> 3)) & 1) != 0;
+#else
+    return pointInPolygonScalar(_xs, _ys, _prevXs, _prevYs, _n, _x, _y);
+#endif
+}
+
+/** \note The SSE2 version tests four points at a time against each edge.
+* \param _xs The x coordinates of the vertices (padded).
+* \param _ys The y coordinates of the vertices (padded).
+* \param _prevXs The x coordinates of the previous vertices (padded).
+* \param _prevYs The y coordinates of the previous vertices (padded).
+* \param _n The number of vertices.
+* \param _pointXs The x coordinates of the points.
+* \param _pointYs The y coordinates of the points.
+* \param _nPoints The number of points.
+* \param _fOffsetX The offset subtracted from the x coordinates of the points (e.g. the origin of the polygon).
+* \param _fOffsetY The offset subtracted from the y coordinates of the points.
+* \param _results For each point, whether or not it is inside the polygon.
+*/
+void pointsInPolygon(const float* _xs, const float* _ys, const float* _prevXs, const float* _prevYs, int _n, const float* _pointXs, const float* _pointYs, int _nPoints, float _fOffsetX, float _fOffsetY, bool* _results)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    __m128 zero = _mm_setzero_ps();
+    __m128 offsetX = _mm_set1_ps(_fOffsetX);
+    __m128 offsetY = _mm_set1_ps(_fOffsetY);
+    for (; i + 4 <= _nPoints; i += 4)
+    {
+        __m128 x = _mm_sub_ps(_mm_loadu_ps(_pointXs + i), offsetX);
+        __m128 y = _mm_sub_ps(_mm_loadu_ps(_pointYs + i), offsetY);
+        __m128 inside = zero;
+        for (int e = 0; e < _n; e++)
+        {
+            __m128 x0 = _mm_set1_ps(_xs[e]);
+            __m128 y0 = _mm_set1_ps(_ys[e]);
+            __m128 x1 = _mm_set1_ps(_prevXs[e]);
+            __m128 y1 = _mm_set1_ps(_prevYs[e]);
+            __m128 dy = _mm_sub_ps(y1, y0);
+            __m128 lhs = _mm_mul_ps(_mm_sub_ps(x, x0), dy);
+            __m128 rhs = _mm_mul_ps(_mm_sub_ps(x1, x0), _mm_sub_ps(y, y0));
+            __m128 crosses = _mm_xor_ps(_mm_cmple_ps(y0, y), _mm_cmple_ps(y1, y));
+            __m128 left = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(dy, zero), _mm_cmplt_ps(lhs, rhs)),
+                                    _mm_and_ps(_mm_cmplt_ps(dy, zero), _mm_cmpgt_ps(lhs, rhs)));
+            inside = _mm_xor_ps(inside, _mm_and_ps(crosses, left));
+        }
+        int mask = _mm_movemask_ps(inside);
+        _results[i] = (mask & 1) != 0;
+        _results[i + 1] = (mask & 2) != 0;
+        _results[i + 2] = (mask & 4) != 0;
+        _results[i + 3] = (mask & 8) != 0;
+    }
+#endif
+    for (; i < _nPoints; i++)
+    {
+        _results[i] = pointInPolygonScalar(_xs, _ys, _prevXs, _prevYs, _n, _pointXs[i] - _fOffsetX, _pointYs[i] - _fOffsetY);
+    }
+}
+
+/** \param _xs The x coordinates of the vertices.
+* \param _ys The y coordinates of the vertices.
+* \param _n The number of vertices.
+* \param _x The x coordinate of the point.
+* \param _y The y coordinate of the point.
+* \param _fRadiusSq The squared radius around each vertex.
+* \return The index of the first vertex within the radius of the point, or -1 if there is none.
+*/
+int firstVertexWithinScalar(const float* _xs, const float* _ys, int _n, float _x, float _y, float _fRadiusSq)
+{
+    for (int i = 0; i < _n; i++)
+    {
+        float dx = _x - _xs[i];
+        float dy = _y - _ys[i];
+        if (dx * dx + dy * dy < _fRadiusSq)
+            return i;
+    }
+    return -1;
+}
+
+/** \param _xs The x coordinates of the vertices (padded).
+* \param _ys The y coordinates of the vertices (padded).
+* \param _n The number of vertices.
+* \param _x The x coordinate of the point.
+* \param _y The y coordinate of the point.
+* \param _fRadiusSq The squared radius around each vertex.
+* \return The index of the first vertex within the radius of the point, or -1 if there is none.
+*/
+int firstVertexWithin(const float* _xs, const float* _ys, int _n, float _x, float _y, float _fRadiusSq)
+{
+#if defined(__SSE2__)
+    __m128 x = _mm_set1_ps(_x);
+    __m128 y = _mm_set1_ps(_y);
+    __m128 radiusSq = _mm_set1_ps(_fRadiusSq);
+    for (int i = 0; i < _n; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(x, _mm_loadu_ps(_xs + i));
+        __m128 dy = _mm_sub_ps(y, _mm_loadu_ps(_ys + i));
+        __m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        int mask = _mm_movemask_ps(_mm_cmplt_ps(distSq, radiusSq));
+        if (mask)
+        {
+            // The lowest set bit is the first vertex of the group
+            int lane = 0;
+            while (!(mask & (1 << lane)))
+                lane++;
+            return i + lane;
+        }
+    }
+    return -1;
+#else
+    return firstVertexWithinScalar(_xs, _ys, _n, _x, _y, _fRadiusSq);
+#endif
+}
+
+}
@@ -0,0 +1,35 @@
+#ifndef TACTOGEOMETRY_H
+#define TACTOGEOMETRY_H
+
+/**
+ * \namespace TactoGeometry
+ *
+ * \brief Hit-test kernels over polygons stored as separate x and y arrays.
+ *
+ * The kernels test four vertices or edges at a time with SSE2 when the compiler targets it
+ * (__SSE2__, which is the default on x86-64), and fall back to scalar loops otherwise. The scalar
+ * versions are always available, as a reference and for benchmarks. AVX is not used: it would need a
+ * runtime dispatch, and most stains have a few dozen vertices, although adaptive resolution allows up
+ * to VERTICES_MAX (1024).
+ *
+ * The arrays must hold a multiple of four entries, the entries past the end of the polygon being
+ * NaN (see paddedCount()): every comparison against NaN is false, so padding never hits.
+ * Edge i goes from vertex i to vertex i-1 (the "previous" arrays hold vertex i-1, wrapping around).
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+namespace TactoGeometry
+{
+    /// Returns the number of entries of a padded array that holds _n vertices.
+    inline int paddedCount(int _n) { return (_n + 3) & ~3; }
+
+    bool    pointInPolygon(const float* _xs, const float* _ys, const float* _prevXs, const float* _prevYs, int _n, float _x, float _y); ///< Returns true if and only if the point is inside the polygon.
+    bool    pointInPolygonScalar(const float* _xs, const float* _ys, const float* _prevXs, const float* _prevYs, int _n, float _x, float _y); ///< Scalar version of pointInPolygon().
+    void    pointsInPolygon(const float* _xs, const float* _ys, const float* _prevXs, const float* _prevYs, int _n, const float* _pointXs, const float* _pointYs, int _nPoints, float _fOffsetX, float _fOffsetY, bool* _results); ///< Tests many points, offset by (-_fOffsetX, -_fOffsetY), against one polygon.
+    int     firstVertexWithin(const float* _xs, const float* _ys, int _n, float _x, float _y, float _fRadiusSq); ///< Returns the first vertex closer to the point than the radius, or -1.
+    int     firstVertexWithinScalar(const float* _xs, const float* _ys, int _n, float _x, float _y, float _fRadiusSq); ///< Scalar version of firstVertexWithin().
+}
+
+#endif // TACTOGEOMETRY_H
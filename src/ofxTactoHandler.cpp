@@ -1,197 +1,271 @@
 #include "ofxTactoHandler.h"
 
+ofxTactoHandler::ofxTactoHandler() : bThreaded(false), bLegacyEvents(true), recorder(NULL)
+{
+}
+
+ofxTactoHandler::~ofxTactoHandler()
+{
+    tuiothread.stop();
+}
+
 void ofxTactoHandler::setup()
 {
-    tuiorcvr.setup(TUIOPORT);
+    setup(false);
+}
+
+/** \note In threaded mode, OSC packets are received and decoded on a background thread,
+* and update() only applies the decoded records. Events are still fired from update().
+* \param _bThreaded Whether or not TUIO data is received on a background thread.
+*/
+void ofxTactoHandler::setup(bool _bThreaded)
+{
+    bThreaded = _bThreaded;
+    if (bThreaded)
+    {
+        tuiothread.setup(TUIOPORT);
+    }
+    else
+    {
+        tuiorcvr.setup(TUIOPORT);
+    }
 }
 
 void ofxTactoHandler::update()
 {
+    ofxTactoTuioRecord record;
+    if (bThreaded)
+    {
+        // The messages were already decoded by the receive thread
+        while (tuiothread.popRecord(record))
+        {
+            ApplyRecord(record);
+        }
+        return;
+    }
+
 	while(tuiorcvr.hasWaitingMessages())
 	{
 		// get the next message
 		ofxOscMessage m;
 		tuiorcvr.getNextMessage(&m);
 
-		// check for mouse moved message
-		if (m.getAddress() == "/tuio/2Dcur")
+		decodedRecords.clear();
+		ofxTactoTuioReceiver::decode(m, decodedRecords, ofGetElapsedTimeMicros());
+		for (unsigned int i = 0; i < decodedRecords.size(); i++)
 		{
-		    string msg = m.getArgAsString(0);
-		    if (msg == "set")
-		    {
-				float blobID = m.getArgAsInt32(1);
-				float posX = m.getArgAsFloat(2);
-				float posZ = m.getArgAsFloat(3);
-				float velX = m.getArgAsFloat(4);
-				float velZ = m.getArgAsFloat(5);
-				float height = 0;
-				float width = 0;
-				float accel = 0;
-				if(m.getNumArgs() > 6)
-					m.getArgAsFloat(6);
-				if(m.getNumArgs() > 7)
-					width = m.getArgAsFloat(7);
-				if(m.getNumArgs() > 8)
-					accel = m.getArgAsFloat(8);
-
-				if (! IsBlobRegistered(blobID))
-				{
-				    // Add the current blob
-				    ofxTactoBlob newBlob = ofxTactoBlob(blobID, posX, posZ, velX, velZ, height, width, accel);
-				    AppendBlob(newBlob);
-				    touchDown(posX, posZ, blobID);
-				}
-				else
-				{
-				    // Exists, so update its info
-                    list<ofxTactoBlob>::iterator it;
-                    for (it = listBlobs.begin(); it != listBlobs.end(); ++it)
-                    {
-                        if ((*it).id == blobID)
-                        {
-                            (*it).x = posX;
-                            (*it).y = posZ;
-                            (*it).vx = velX;
-                            (*it).vy = velZ;
-                            (*it).height = height;
-                            (*it).width = width;
-                            (*it).accel = accel;
-                            touchMoved(posX, posZ, blobID);
-                        }
-                    }
-				}
-		    }
-		    if (msg == "alive")
-		    {
-		        int numArgs = m.getNumArgs();
-		        if (numArgs == 1)
-		        {
-					// For each blob in the list, send TouchUp message
-                    list<ofxTactoBlob>::iterator it;
-                    for (it = listBlobs.begin(); it != listBlobs.end(); ++it)
-                    {
-						touchUp((*it).x, (*it).y, (*it).id);
-                    }
-		            // Clear the vector, there are no blobs!
-		            listBlobs.clear();
-		        }
-		        else
-		        {
-		            ManageBlobs(m);
-		        }
-		    }
+			ApplyRecord(decodedRecords[i]);
 		}
 	}
 }
 
+/** \param record The decoded TUIO record.
+*/
+void ofxTactoHandler::ApplyRecord(const ofxTactoTuioRecord& record)
+{
+    if (recorder)
+    {
+        recorder->write(record);
+    }
+    if (trackers[record.profile].applyRecord(record))
+    {
+        FireFrameEvents(record.profile);
+    }
+}
+
+/** \note The batched event is fired first. For cursors, the per-touch events follow when legacy
+* events are enabled.
+* \param profile The TUIO profile of the frame.
+*/
+void ofxTactoHandler::FireFrameEvents(int profile)
+{
+    const vector<ofxTactoTouchEvent>& frameEvents = trackers[profile].getFrameEvents();
+    if (frameEvents.empty())
+        return;
+
+    ofxTactoTouchBatchEventArgs batchArgs;
+    batchArgs.events = &frameEvents[0];
+    batchArgs.numEvents = frameEvents.size();
+    if (profile == TUIO_PROFILE_OBJECT)
+    {
+        ofNotifyEvent(objectBatch, batchArgs, this);
+        return;
+    }
+    if (profile == TUIO_PROFILE_SHAPE)
+    {
+        ofNotifyEvent(shapeBatch, batchArgs, this);
+        return;
+    }
+    ofxTactoLatencyMonitor::get().beginFrame(trackers[profile].getFrameReceiptTime());
+    ofNotifyEvent(touchBatch, batchArgs, this);
+
+    if (!bLegacyEvents)
+        return;
+
+    for (unsigned int i = 0; i < frameEvents.size(); i++)
+    {
+        const ofxTactoTouchEvent& event = frameEvents[i];
+        switch (event.type)
+        {
+            case TACTO_TOUCH_DOWN:
+                touchDown(event.x, event.y, event.id);
+                break;
+            case TACTO_TOUCH_MOVED:
+                touchMoved(event.x, event.y, event.id);
+                break;
+            case TACTO_TOUCH_UP:
+                touchUp(event.x, event.y, event.id);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
 void ofxTactoHandler::drawBlobs()
 {
-    list<ofxTactoBlob>::iterator it;
-    for (it = listBlobs.begin(); it != listBlobs.end(); ++it)
+    ofxTactoBlobView blobs = getBlobView();
+    for (int i = 0; i < blobs.size(); i++)
     {
-        (*it).draw();
+        ofxTactoBlob blob = blobs[i];
+        blob.draw();
     }
 }
 
-/** \return The list of blobs in the touch system.
+/** \note This copies every blob; prefer getBlobView() in code that runs every frame.
+* \return The list of blobs in the touch system.
 */
 list<ofxTactoBlob> ofxTactoHandler::getBlobs()
 {
-    return listBlobs;
+    ofxTactoBlobView blobs = getBlobView();
+    return list<ofxTactoBlob>(blobs.begin(), blobs.end());
+}
+
+/** \note The view reflects the last applied frame and stays valid until the next call to update().
+* It must only be used from the thread that calls update(); other threads should use getSnapshot().
+* \return A view over the blobs in the touch system.
+*/
+ofxTactoBlobView ofxTactoHandler::getBlobView()
+{
+    return trackers[TUIO_PROFILE_CURSOR].getView();
+}
+
+/** \note The snapshot is written by update(). A single other thread may read it at any rate with
+* ofxTactoBlobSnapshot::acquire(), without locks.
+* \return The snapshot of the blobs in the touch system.
+*/
+ofxTactoBlobSnapshot& ofxTactoHandler::getSnapshot()
+{
+    return trackers[TUIO_PROFILE_CURSOR].getSnapshot();
+}
+
+/** \note The fields are stored as one array per field, indexed by slot, for sweeps over all the blobs.
+* \return The table of blobs in the touch system.
+*/
+const ofxTactoBlobTable& ofxTactoHandler::getBlobTable()
+{
+    return trackers[TUIO_PROFILE_CURSOR].getTable();
+}
+
+/** \note The class ID and angle of each object are in ofxTactoBlob::classId and ofxTactoBlob::angle.
+* \return A view over the TUIO objects.
+*/
+ofxTactoBlobView ofxTactoHandler::getObjectView()
+{
+    return trackers[TUIO_PROFILE_OBJECT].getView();
+}
+
+/** \return The table of TUIO objects.
+*/
+const ofxTactoBlobTable& ofxTactoHandler::getObjectTable()
+{
+    return trackers[TUIO_PROFILE_OBJECT].getTable();
+}
+
+/** \return The snapshot of the TUIO objects.
+*/
+ofxTactoBlobSnapshot& ofxTactoHandler::getObjectSnapshot()
+{
+    return trackers[TUIO_PROFILE_OBJECT].getSnapshot();
+}
+
+/** \return A view over the TUIO shapes.
+*/
+ofxTactoBlobView ofxTactoHandler::getShapeView()
+{
+    return trackers[TUIO_PROFILE_SHAPE].getView();
+}
+
+/** \return The table of TUIO shapes.
+*/
+const ofxTactoBlobTable& ofxTactoHandler::getShapeTable()
+{
+    return trackers[TUIO_PROFILE_SHAPE].getTable();
+}
+
+/** \return The snapshot of the TUIO shapes.
+*/
+ofxTactoBlobSnapshot& ofxTactoHandler::getShapeSnapshot()
+{
+    return trackers[TUIO_PROFILE_SHAPE].getSnapshot();
 }
 
 /** \return The number of blobs currently in the system.
 */
 int ofxTactoHandler::numBlobs()
 {
-    return listBlobs.size();
+    return trackers[TUIO_PROFILE_CURSOR].getTable().size();
 }
 
-/** \param m The TUIO message that is parsed.
+/** \note This is how recorded or synthetic TUIO data is fed to the handler (see \link ofxTactoTuioPlayer).
+* The record goes through the same path as the records received from the network.
+* \param record The decoded TUIO record.
 */
-void ofxTactoHandler::ManageBlobs(ofxOscMessage m)
+void ofxTactoHandler::injectRecord(const ofxTactoTuioRecord& record)
 {
-    int numArgs = m.getNumArgs();
-    int numAliveBlobs = numArgs - 1;
-
-    // Create vector of alive blobs
-    vector<int> aliveBlobIDs;
-    if (numAliveBlobs > 0) // only if there are blobs
-    {
-        for (int i=0; i<numAliveBlobs; i++)
-        {
-            int currAliveBlob = m.getArgAsInt32(i + 1);
-            aliveBlobIDs.push_back(currAliveBlob);
-        }
+    ApplyRecord(record);
+}
 
-        // Traverse list of maintained blobs and remove those that are not alive
-        list<ofxTactoBlob>::iterator it = listBlobs.begin();
-        while (it != listBlobs.end())
-        {
-            if (IsBlobIDInVector((*it).id, aliveBlobIDs))
-            {
-                // Leave blob as is
-                ++it;
-            }
-            else
-            {
-                // Remove blob
-                touchUp((*it).x, (*it).y, (*it).id);
-                listBlobs.erase(it++);
-            }
-        }
-    }
+/** \note The handler does not own the recorder. Pass NULL to stop writing to it.
+* \param _recorder The recorder to which every applied record is written.
+*/
+void ofxTactoHandler::setRecorder(ofxTactoTuioRecorder* _recorder)
+{
+    recorder = _recorder;
 }
 
-/** \param blobID The ID of the blob.
-* \return Whether or not the queried blob ID is in the current list of blobs.
+/** \note The filter is disabled by default. Enable it with ofxTactoCursorFilter::setEnabled(), and
+* set ofxTactoCursorFilter::setPrediction() to the latency of the setup to hide it. Touch events,
+* views and snapshots then report the filtered positions.
+* \return The smoothing and prediction stage of the cursors.
 */
-bool ofxTactoHandler::IsBlobRegistered(int blobID)
+ofxTactoCursorFilter& ofxTactoHandler::getCursorFilter()
 {
-    bool breturn = false;
-    list<ofxTactoBlob>::const_iterator it;
-    for (it = listBlobs.begin(); it != listBlobs.end(); ++it)
-    {
-        if ((*it).id == blobID)
-        {
-            breturn = true;
-            break;
-        }
-    }
-    return breturn;
+    return trackers[TUIO_PROFILE_CURSOR].getFilter();
 }
 
-/** \param blobID The ID of the blob.
-* \param vectorIDs A vector of blob IDs.
-* \return Whether or not the queried blob ID is in the queried vector of blobs.
+/** \note The legacy events are enabled by default, so that existing applications that listen to
+* ofEvents().touchDown, touchMoved and touchUp keep working.
+* \param _bEnabled Whether or not the per-touch events are fired.
 */
-bool ofxTactoHandler::IsBlobIDInVector(int blobID, vector<int> vectorIDs)
+void ofxTactoHandler::setLegacyEventsEnabled(bool _bEnabled)
 {
-    bool breturn = false;
-    vector<int>::const_iterator it;
-    for (it = vectorIDs.begin(); it != vectorIDs.end(); ++it)
-    {
-        if (*it == blobID)
-        {
-            breturn = true;
-            break;
-        }
-    }
-    return breturn;
+    bLegacyEvents = _bEnabled;
 }
 
-/** \param newblob The blob to append to the list of blobs in the system.
+/** \return Whether or not the per-touch events are fired.
 */
-void ofxTactoHandler::AppendBlob(ofxTactoBlob newblob)
+bool ofxTactoHandler::areLegacyEventsEnabled()
 {
-    listBlobs.push_back(newblob);
+    return bLegacyEvents;
 }
 
 /**
 * \param x The x coordinate of the touch event.
 * \param y The y coordinate of the touch event.
 * \param x The ID of the touch point.
-*/void ofxTactoHandler::touchDown(float x, float y, int touchId)
+*/
+void ofxTactoHandler::touchDown(float x, float y, int touchId)
 {
 	ofTouchEventArgs touchArgs;
 	touchArgs.x = x;
@@ -17,34 +17,74 @@
 #include "ofMain.h"
 #include "ofxOsc.h"
 #include "ofxTactoBlob.h"
+#include "ofxTactoBlobTable.h"
+#include "ofxTactoBlobSnapshot.h"
+#include "ofxTactoTuioReceiver.h"
+#include "ofxTactoTuioTracker.h"
+#include "ofxTactoTuioRecorder.h"
+#include "ofxTactoTouchEvent.h"
+#include "ofxTactoLatencyMonitor.h"
 
 #define TUIOPORT 3333
 
 enum BLOB_METHOD { NAIVE, CLOSEST };
 
-/// A class that provides support for the TUIO protocol.
+/** \brief A class that provides support for the TUIO protocol.
+*
+* The handler tracks the 2Dcur (cursor), 2Dobj (object) and 2Dblb (shape) profiles, each with
+* its own \link ofxTactoTuioTracker. The cursors are the "blobs" of the touch system. Objects and
+* shapes get their own event streams and views. The word "shape" is used for 2Dblb, because
+* "blob" already means a cursor in this addon.
+*/
 class ofxTactoHandler : public ofBaseApp
 {
     public:
+        ofxTactoHandler(); ///< Constructor
+        ~ofxTactoHandler(); ///< Destructor
 		void                setup(); ///< Regular OpenFrameworks function.
+		void                setup(bool _bThreaded); ///< Sets up the handler, optionally receiving TUIO data on a background thread.
 		void                update(); ///< Regular OpenFrameworks function.
 		void                drawBlobs(); ///< Draws the blobs.
 		int                 numBlobs(); ///< Returns the number of blobs in the system.
 		list<ofxTactoBlob>	getBlobs(); ///< Returns a list of the blobs in the system.
+		ofxTactoBlobView    getBlobView(); ///< Returns a read-only view of the blobs in the system, without copying them.
+		const ofxTactoBlobTable& getBlobTable(); ///< Returns the table of blobs, whose fields can be swept as separate arrays.
+		ofxTactoBlobSnapshot& getSnapshot(); ///< Returns the snapshot of the blobs that another thread can read without locks.
+		ofxTactoBlobView    getObjectView(); ///< Returns a read-only view of the TUIO objects (2Dobj).
+		const ofxTactoBlobTable& getObjectTable(); ///< Returns the table of TUIO objects (2Dobj).
+		ofxTactoBlobSnapshot& getObjectSnapshot(); ///< Returns the snapshot of the TUIO objects (2Dobj) for another thread.
+		ofxTactoBlobView    getShapeView(); ///< Returns a read-only view of the TUIO shapes (2Dblb).
+		const ofxTactoBlobTable& getShapeTable(); ///< Returns the table of TUIO shapes (2Dblb).
+		ofxTactoBlobSnapshot& getShapeSnapshot(); ///< Returns the snapshot of the TUIO shapes (2Dblb) for another thread.
 
         void				touchDown(float x, float y, int touchId); ///< Regular OpenFrameworks function.
         void				touchMoved(float x, float y, int touchId); ///< Regular OpenFrameworks function.
         void				touchUp(float x, float y, int touchId); ///< Regular OpenFrameworks function.
         void				touchDoubleTap(float x, float y, int touchId); ///< Regular OpenFrameworks function.
 
+        void                injectRecord(const ofxTactoTuioRecord& record); ///< Applies a decoded TUIO record that did not come from the network.
+        void                setRecorder(ofxTactoTuioRecorder* _recorder); ///< Writes every applied TUIO record to a recorder.
+
+        ofxTactoCursorFilter& getCursorFilter(); ///< Returns the smoothing and prediction stage of the cursors.
+
+        void                setLegacyEventsEnabled(bool _bEnabled); ///< Fires (or not) the per-touch OpenFrameworks events besides the batched one.
+        bool                areLegacyEventsEnabled(); ///< Returns true if and only if the per-touch OpenFrameworks events are fired.
+
+        ofEvent<ofxTactoTouchBatchEventArgs> touchBatch; ///< Fired once per frame with all the touch changes of the frame.
+        ofEvent<ofxTactoTouchBatchEventArgs> objectBatch; ///< Fired once per frame with all the changes of the TUIO objects (2Dobj).
+        ofEvent<ofxTactoTouchBatchEventArgs> shapeBatch; ///< Fired once per frame with all the changes of the TUIO shapes (2Dblb).
+
     private:
-        void                ManageBlobs(ofxOscMessage m); ///< Updates the list of active blobs.
-        bool                IsBlobRegistered(int blobID); ///< Returns true if and only if the queried ID is in the current list of blobs.
-        static bool         IsBlobIDInVector(int blobID, vector<int> vectorIDs); ///< Static function that returns true if and only if the queried ID is in the queried vector.
-        void                AppendBlob(ofxTactoBlob newblob); ///< Appends a blob to the list of blobs.
+        void                ApplyRecord(const ofxTactoTuioRecord& record); ///< Passes a decoded TUIO record to the tracker of its profile.
+        void                FireFrameEvents(int profile); ///< Fires the events of the frame that a tracker just applied.
 
-        ofxOscReceiver      tuiorcvr; ///< The OSC packet listener that reads TUIO data.
-        list<ofxTactoBlob>  listBlobs; ///< The list of blobs in the touch system.
+        bool                bThreaded; ///< Whether or not TUIO data is received on a background thread.
+        bool                bLegacyEvents; ///< Whether or not the per-touch OpenFrameworks events are fired.
+        ofxOscReceiver      tuiorcvr; ///< The OSC packet listener that reads TUIO data (when not threaded).
+        ofxTactoTuioReceiver tuiothread; ///< The background thread that reads TUIO data (when threaded).
+        vector<ofxTactoTuioRecord> decodedRecords; ///< Scratch buffer for the records of one message (when not threaded).
+        ofxTactoTuioTracker trackers[TUIO_PROFILE_COUNT]; ///< The tracked state of each TUIO profile.
+        ofxTactoTuioRecorder* recorder; ///< The recorder to which applied records are written (NULL when not recording).
 };
 
 #endif // TACTOHANDLER_H
@@ -0,0 +1,183 @@
+#include "ofxTactoLatencyMonitor.h"
+
+static const char* stageNames[TACTO_LATENCY_STAGE_COUNT] = { "apply", "widget", "draw" };
+
+ofxTactoLatencyMonitor::ofxTactoLatencyMonitor() : m_bEnabled(false), m_nNumPending(0)
+{
+    reset();
+}
+
+/** \return The monitor of the application.
+*/
+ofxTactoLatencyMonitor& ofxTactoLatencyMonitor::get()
+{
+    static ofxTactoLatencyMonitor monitor;
+    return monitor;
+}
+
+/** \param _bEnabled Whether or not the latency is measured.
+*/
+void ofxTactoLatencyMonitor::setEnabled(bool _bEnabled)
+{
+    m_bEnabled = _bEnabled;
+    m_nNumPending = 0;
+}
+
+/** \return Whether or not the latency is measured.
+*/
+bool ofxTactoLatencyMonitor::isEnabled() const
+{
+    return m_bEnabled;
+}
+
+/** \note The handler calls this for every cursor frame with touch changes. The frames not drawn yet
+* wait for the next draw, which closes all of them, so frames applied several times per draw are all
+* measured. Beyond LATENCY_MAX_PENDING waiting frames, the newest one is replaced.
+* \param _nReceiptTime The time at which the frame was received (see ofGetElapsedTimeMicros()).
+*/
+void ofxTactoLatencyMonitor::beginFrame(unsigned long long _nReceiptTime)
+{
+    if (!m_bEnabled)
+        return;
+    if (m_nNumPending == LATENCY_MAX_PENDING)
+        m_nNumPending--;
+    m_pendingTimes[m_nNumPending++] = _nReceiptTime;
+    for (int i = 0; i < TACTO_LATENCY_STAGE_COUNT; i++)
+    {
+        m_bMarked[i] = false;
+    }
+    mark(TACTO_LATENCY_APPLY);
+}
+
+/** \note The draw stage is recorded for every frame waiting for a draw; the other stages for the current frame.
+* \param _stage The stage that was reached (see TACTO_LATENCY_STAGE).
+*/
+void ofxTactoLatencyMonitor::mark(int _stage)
+{
+    if (!m_bEnabled || m_nNumPending == 0 || m_bMarked[_stage])
+        return;
+    unsigned long long now = ofGetElapsedTimeMicros();
+    if (_stage == TACTO_LATENCY_DRAW)
+    {
+        // Nothing happens to the frames after they are drawn
+        for (int i = 0; i < m_nNumPending; i++)
+        {
+            record(_stage, now > m_pendingTimes[i] ? now - m_pendingTimes[i] : 0);
+        }
+        m_nNumPending = 0;
+        return;
+    }
+    m_bMarked[_stage] = true;
+    unsigned long long receiptTime = m_pendingTimes[m_nNumPending - 1];
+    record(_stage, now > receiptTime ? now - receiptTime : 0);
+}
+
+void ofxTactoLatencyMonitor::reset()
+{
+    for (int i = 0; i < TACTO_LATENCY_STAGE_COUNT; i++)
+    {
+        memset(&m_stages[i], 0, sizeof(stageHistogram));
+        m_bMarked[i] = false;
+    }
+    m_nNumPending = 0;
+}
+
+/** \param _stage The stage (see TACTO_LATENCY_STAGE).
+* \return The number of frames measured at the stage.
+*/
+unsigned int ofxTactoLatencyMonitor::getCount(int _stage) const
+{
+    return m_stages[_stage].count;
+}
+
+/** \param _stage The stage (see TACTO_LATENCY_STAGE).
+* \return The mean latency of the stage, in microseconds (0 if nothing was measured).
+*/
+float ofxTactoLatencyMonitor::getMean(int _stage) const
+{
+    const stageHistogram& stage = m_stages[_stage];
+    return stage.count > 0 ? (float)stage.sum / stage.count : 0;
+}
+
+/** \param _stage The stage (see TACTO_LATENCY_STAGE).
+* \return The largest latency of the stage, in microseconds.
+*/
+unsigned long long ofxTactoLatencyMonitor::getMax(int _stage) const
+{
+    return m_stages[_stage].max;
+}
+
+/** \note The result is the upper edge of the bucket that holds the percentile, so it is precise
+* to LATENCY_BUCKET_WIDTH microseconds. Beyond the last bucket, the largest latency is returned.
+* \param _stage The stage (see TACTO_LATENCY_STAGE).
+* \param _fPercentile The percentile, in [0;100].
+* \return The latency under which this percentage of the frames fall, in microseconds.
+*/
+unsigned long long ofxTactoLatencyMonitor::getPercentile(int _stage, float _fPercentile) const
+{
+    const stageHistogram& stage = m_stages[_stage];
+    if (stage.count == 0)
+        return 0;
+    unsigned int target = (unsigned int)ceil(stage.count * _fPercentile / 100.0f);
+    unsigned int total = 0;
+    for (int i = 0; i < LATENCY_NUM_BUCKETS - 1; i++)
+    {
+        total += stage.buckets[i];
+        if (total >= target && total > 0)
+            return MIN((unsigned long long)(i + 1) * LATENCY_BUCKET_WIDTH, stage.max);
+    }
+    return stage.max;
+}
+
+/** \param _stage The stage (see TACTO_LATENCY_STAGE).
+* \return The number of frames in each bucket; bucket i holds latencies in [i;i+1[ * LATENCY_BUCKET_WIDTH.
+*/
+const unsigned int* ofxTactoLatencyMonitor::getHistogram(int _stage) const
+{
+    return m_stages[_stage].buckets;
+}
+
+/** \note The file starts with one line of statistics per stage, followed by the non-empty buckets.
+* \param _path The path of the file, relative to the data folder.
+* \return Whether or not the file was written.
+*/
+bool ofxTactoLatencyMonitor::dump(const string& _path) const
+{
+    ofstream file(ofToDataPath(_path).c_str());
+    if (!file.is_open())
+    {
+        ofLogError() << "ofxTactoLatencyMonitor: cannot write " << _path;
+        return false;
+    }
+
+    file << "stage,count,mean_us,p50_us,p95_us,p99_us,max_us" << endl;
+    for (int i = 0; i < TACTO_LATENCY_STAGE_COUNT; i++)
+    {
+        file << stageNames[i] << "," << getCount(i) << "," << getMean(i) << "," << getPercentile(i, 50)
+            << "," << getPercentile(i, 95) << "," << getPercentile(i, 99) << "," << getMax(i) << endl;
+    }
+    file << endl << "stage,bucket_start_us,count" << endl;
+    for (int i = 0; i < TACTO_LATENCY_STAGE_COUNT; i++)
+    {
+        for (int j = 0; j < LATENCY_NUM_BUCKETS; j++)
+        {
+            if (m_stages[i].buckets[j] > 0)
+                file << stageNames[i] << "," << j * LATENCY_BUCKET_WIDTH << "," << m_stages[i].buckets[j] << endl;
+        }
+    }
+    return true;
+}
+
+/** \param _stage The stage (see TACTO_LATENCY_STAGE).
+* \param _nLatency The latency, in microseconds.
+*/
+void ofxTactoLatencyMonitor::record(int _stage, unsigned long long _nLatency)
+{
+    stageHistogram& stage = m_stages[_stage];
+    unsigned long long bucket = _nLatency / LATENCY_BUCKET_WIDTH;
+    stage.buckets[bucket < LATENCY_NUM_BUCKETS ? bucket : LATENCY_NUM_BUCKETS - 1]++;
+    stage.count++;
+    stage.sum += _nLatency;
+    if (_nLatency > stage.max)
+        stage.max = _nLatency;
+}
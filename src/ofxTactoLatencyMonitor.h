@@ -0,0 +1,78 @@
+#ifndef TACTOLATENCYMONITOR_H
+#define TACTOLATENCYMONITOR_H
+
+/**
+ * \class ofxTactoLatencyMonitor
+ *
+ * \brief Histograms of the input latency, from the arrival of TUIO data to the draw that shows it.
+ *
+ * Each cursor frame applied by the \link ofxTactoHandler carries the time at which its first
+ * message was received. The latency of a stage is the time from that receipt to the first time
+ * the stage is reached for the frame:
+ * - TACTO_LATENCY_APPLY: the handler applied the frame and fires its events;
+ * - TACTO_LATENCY_WIDGET: a widget handled a touch of the frame;
+ * - TACTO_LATENCY_DRAW: a widget was drawn after the frame.
+ *
+ * There is one monitor per application, reached with get(). It is disabled by default. Once
+ * enabled, recording allocates no memory. Everything happens on the thread that calls
+ * ofxTactoHandler::update() and draws.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include "ofMain.h"
+
+#define LATENCY_NUM_BUCKETS 400 ///< The number of buckets in each histogram.
+#define LATENCY_BUCKET_WIDTH 250 ///< The width of a bucket, in microseconds (the last bucket holds everything beyond).
+#define LATENCY_MAX_PENDING 32 ///< The number of frames that can wait for a draw.
+
+/// The stages at which the latency is measured.
+enum TACTO_LATENCY_STAGE {
+    TACTO_LATENCY_APPLY, ///< The frame was applied by the handler.
+    TACTO_LATENCY_WIDGET, ///< A widget handled a touch of the frame.
+    TACTO_LATENCY_DRAW, ///< A widget was drawn after the frame.
+    TACTO_LATENCY_STAGE_COUNT ///< The number of stages.
+};
+
+/// A class that measures the latency of the input path.
+class ofxTactoLatencyMonitor
+{
+    public:
+        static ofxTactoLatencyMonitor& get(); ///< Returns the monitor of the application.
+
+        void                setEnabled(bool _bEnabled); ///< Enables or disables the measurements.
+        bool                isEnabled() const; ///< Returns true if and only if the latency is measured.
+        void                beginFrame(unsigned long long _nReceiptTime); ///< Starts measuring a new frame, and records the apply stage.
+        void                mark(int _stage); ///< Records the latency of a stage for the current frame, the first time it is reached.
+        void                reset(); ///< Clears the histograms.
+
+        unsigned int        getCount(int _stage) const; ///< Returns the number of frames measured at a stage.
+        float               getMean(int _stage) const; ///< Returns the mean latency of a stage, in microseconds.
+        unsigned long long  getMax(int _stage) const; ///< Returns the largest latency of a stage, in microseconds.
+        unsigned long long  getPercentile(int _stage, float _fPercentile) const; ///< Returns a percentile of the latency of a stage, in microseconds.
+        const unsigned int* getHistogram(int _stage) const; ///< Returns the LATENCY_NUM_BUCKETS counts of a stage.
+        bool                dump(const string& _path) const; ///< Writes the statistics and histograms to a CSV file.
+
+    private:
+        ofxTactoLatencyMonitor(); ///< Constructor
+        ofxTactoLatencyMonitor(const ofxTactoLatencyMonitor&); ///< Not copyable.
+
+        /// The measurements of one stage.
+        struct stageHistogram {
+            unsigned int buckets[LATENCY_NUM_BUCKETS]; ///< The number of frames in each bucket.
+            unsigned int count; ///< The number of frames measured.
+            unsigned long long sum; ///< The sum of the latencies, in microseconds.
+            unsigned long long max; ///< The largest latency, in microseconds.
+        };
+
+        void                record(int _stage, unsigned long long _nLatency); ///< Adds a latency to the histogram of a stage.
+
+        bool                m_bEnabled; ///< Whether or not the latency is measured.
+        unsigned long long  m_pendingTimes[LATENCY_MAX_PENDING]; ///< The receipt times of the frames not drawn yet, oldest first, in microseconds.
+        int                 m_nNumPending; ///< The number of frames not drawn yet; the last one is the current frame.
+        bool                m_bMarked[TACTO_LATENCY_STAGE_COUNT]; ///< Whether or not each stage was reached for the current frame.
+        stageHistogram      m_stages[TACTO_LATENCY_STAGE_COUNT]; ///< The measurements of each stage.
+};
+
+#endif // TACTOLATENCYMONITOR_H
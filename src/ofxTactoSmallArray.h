@@ -0,0 +1,212 @@
+#ifndef TACTOSMALLARRAY_H
+#define TACTOSMALLARRAY_H
+
+/**
+ * \class ofxTactoSmallArray
+ *
+ * \brief A resizable array that holds up to INLINE items in place, and larger contents in pooled blocks.
+ *
+ * Small arrays cost no allocation at all. Beyond INLINE items, the storage comes from blocks whose
+ * capacities are powers of two; released blocks are kept in per-capacity free lists (shared by all
+ * the arrays of the same type) and reused, so growing and shrinking back and forth does not touch
+ * the heap once the pool is warm. The pool is not thread-safe, like the rest of the UI. The cached
+ * blocks are freed at exit; arrays destroyed after that (static arrays) free their blocks directly.
+ *
+ * T must be default-constructible and assignable.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include <vector>
+
+/// A class that implements an array with inline storage for few items.
+template <class T, int INLINE>
+class ofxTactoSmallArray
+{
+    public:
+        ofxTactoSmallArray() : m_ptItems(m_inline), m_nSize(0), m_nCapacity(INLINE) {} ///< Constructor
+        ofxTactoSmallArray(const ofxTactoSmallArray& _other) : m_ptItems(m_inline), m_nSize(0), m_nCapacity(INLINE) { *this = _other; } ///< Copy constructor
+        ~ofxTactoSmallArray() { release(); } ///< Destructor
+
+        /** \param _other The array to copy.
+        * \return This array.
+        */
+        ofxTactoSmallArray& operator=(const ofxTactoSmallArray& _other)
+        {
+            if (this != &_other)
+            {
+                reserve(_other.m_nSize);
+                for (int i = 0; i < _other.m_nSize; i++)
+                {
+                    m_ptItems[i] = _other.m_ptItems[i];
+                }
+                m_nSize = _other.m_nSize;
+            }
+            return *this;
+        }
+
+        int         size() const { return m_nSize; } ///< Returns the number of items.
+        int         capacity() const { return m_nCapacity; } ///< Returns the number of items that fit without growing.
+        bool        isInline() const { return m_ptItems == m_inline; } ///< Returns true if and only if the items are stored in place.
+        T*          data() { return m_ptItems; } ///< Returns the contiguous items.
+        const T*    data() const { return m_ptItems; } ///< Returns the contiguous items.
+        T&          operator[](int _nIndex) { return m_ptItems[_nIndex]; } ///< Returns an item.
+        const T&    operator[](int _nIndex) const { return m_ptItems[_nIndex]; } ///< Returns an item.
+
+        /** \note New items are default-constructed; the items kept keep their values.
+        * \param _nSize The new number of items.
+        */
+        void resize(int _nSize)
+        {
+            reserve(_nSize);
+            for (int i = m_nSize; i < _nSize; i++)
+            {
+                m_ptItems[i] = T();
+            }
+            m_nSize = _nSize;
+            // Give large blocks back to the pool when the contents shrink a lot
+            if (!isInline() && m_nSize <= m_nCapacity / 4)
+                shrink();
+        }
+
+        /** \param _nCapacity The number of items that must fit without growing.
+        */
+        void reserve(int _nCapacity)
+        {
+            if (_nCapacity <= m_nCapacity)
+                return;
+            move(1 << sizeClass(_nCapacity));
+        }
+
+        /** \param _nIndex The index at which to insert, from 0 to size().
+        * \param _item The item to insert.
+        */
+        void insert(int _nIndex, const T& _item)
+        {
+            reserve(m_nSize + 1);
+            for (int i = m_nSize; i > _nIndex; i--)
+            {
+                m_ptItems[i] = m_ptItems[i - 1];
+            }
+            m_ptItems[_nIndex] = _item;
+            m_nSize++;
+        }
+
+        /** \param _nIndex The index of the item to remove.
+        */
+        void erase(int _nIndex)
+        {
+            for (int i = _nIndex; i + 1 < m_nSize; i++)
+            {
+                m_ptItems[i] = m_ptItems[i + 1];
+            }
+            m_nSize--;
+        }
+
+    private:
+        T           m_inline[INLINE]; ///< The in-place storage.
+        T*          m_ptItems; ///< The items: m_inline, or a pooled block.
+        int         m_nSize; ///< The number of items.
+        int         m_nCapacity; ///< The number of items m_ptItems can hold.
+
+        /// The free blocks of each power-of-two capacity.
+        struct pool
+        {
+            std::vector<T*> blocks[32]; ///< The free blocks, by power of two.
+
+            /// Frees the cached blocks when the program exits.
+            ~pool()
+            {
+                for (int i = 0; i < 32; i++)
+                {
+                    for (unsigned int j = 0; j < blocks[i].size(); j++)
+                    {
+                        delete[] blocks[i][j];
+                    }
+                }
+                isPoolDestroyed() = true;
+            }
+        };
+
+        /// Returns the free blocks of each power-of-two capacity, or 0 once the pool was destroyed.
+        static std::vector<T*>* freeBlocks()
+        {
+            if (isPoolDestroyed())
+                return 0;
+            static pool freePool;
+            return freePool.blocks;
+        }
+
+        /// Returns whether or not the pool was destroyed. The flag has no destructor, so it outlives the pool.
+        static bool& isPoolDestroyed()
+        {
+            static bool bDestroyed = false;
+            return bDestroyed;
+        }
+
+        /// Returns the power of two of a capacity.
+        static int sizeClass(int _nCapacity)
+        {
+            int nClass = 0;
+            while ((1 << nClass) < _nCapacity)
+            {
+                nClass++;
+            }
+            return nClass;
+        }
+
+        /** \param _nCapacity The capacity of the storage to move the items to.
+        */
+        void move(int _nCapacity)
+        {
+            T* ptItems = m_inline;
+            if (_nCapacity > INLINE)
+            {
+                std::vector<T*>* blocks = freeBlocks();
+                std::vector<T*>* sizeBlocks = blocks ? &blocks[sizeClass(_nCapacity)] : 0;
+                if (!sizeBlocks || sizeBlocks->empty())
+                {
+                    ptItems = new T[_nCapacity];
+                }
+                else
+                {
+                    ptItems = sizeBlocks->back();
+                    sizeBlocks->pop_back();
+                }
+            }
+            else
+            {
+                _nCapacity = INLINE;
+            }
+            for (int i = 0; i < m_nSize; i++)
+            {
+                ptItems[i] = m_ptItems[i];
+            }
+            release();
+            m_ptItems = ptItems;
+            m_nCapacity = _nCapacity;
+        }
+
+        /// Moves the items to the smallest storage that holds them.
+        void shrink()
+        {
+            int nCapacity = m_nSize <= INLINE ? INLINE : 1 << sizeClass(m_nSize);
+            if (nCapacity < m_nCapacity)
+                move(nCapacity);
+        }
+
+        /// Gives the block back to the pool, or frees it if the pool is gone.
+        void release()
+        {
+            if (isInline())
+                return;
+            std::vector<T*>* blocks = freeBlocks();
+            if (blocks)
+                blocks[sizeClass(m_nCapacity)].push_back(m_ptItems);
+            else
+                delete[] m_ptItems;
+        }
+};
+
+#endif // TACTOSMALLARRAY_H
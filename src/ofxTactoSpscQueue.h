@@ -0,0 +1,61 @@
+#ifndef TACTOSPSCQUEUE_H
+#define TACTOSPSCQUEUE_H
+
+/**
+ * \class ofxTactoSpscQueue
+ *
+ * \brief A lock-free, fixed-capacity ring buffer for one producer thread and one consumer thread.
+ *
+ * The producer only writes the tail index and the consumer only writes the head index, so
+ * no lock is needed: each side publishes its progress with a release store and observes the
+ * other side with an acquire load. The capacity must be a power of two.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include <atomic>
+
+/// A class that implements a single-producer/single-consumer queue.
+template <class T, unsigned int CAPACITY>
+class ofxTactoSpscQueue
+{
+    public:
+        ofxTactoSpscQueue() : m_nHead(0), m_nTail(0) {} ///< Constructor
+
+        /** \brief Called by the producer only.
+        * \param _item The item to enqueue.
+        * \return Whether or not there was room for the item.
+        */
+        bool push(const T& _item)
+        {
+            unsigned int tail = m_nTail.load(std::memory_order_relaxed);
+            if (tail - m_nHead.load(std::memory_order_acquire) >= CAPACITY)
+                return false;
+            m_items[tail & (CAPACITY - 1)] = _item;
+            m_nTail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** \brief Called by the consumer only.
+        * \param _item Receives the dequeued item.
+        * \return Whether or not an item was dequeued.
+        */
+        bool pop(T& _item)
+        {
+            unsigned int head = m_nHead.load(std::memory_order_relaxed);
+            if (head == m_nTail.load(std::memory_order_acquire))
+                return false;
+            _item = m_items[head & (CAPACITY - 1)];
+            m_nHead.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        T                           m_items[CAPACITY]; ///< The ring storage.
+        std::atomic<unsigned int>   m_nHead; ///< The index of the next item to pop (written by the consumer).
+        char                        m_padding[64]; ///< Keeps the two indices on separate cache lines.
+        std::atomic<unsigned int>   m_nTail; ///< The index of the next item to push (written by the producer).
+};
+
+#endif // TACTOSPSCQUEUE_H
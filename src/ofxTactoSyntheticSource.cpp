@@ -0,0 +1,145 @@
+#include "ofxTactoSyntheticSource.h"
+
+ofxTactoSyntheticSource::ofxTactoSyntheticSource() :
+    m_fSpeed(0), m_fChurnRate(0), m_fFrameRate(60), m_nRandomState(1), m_nNextId(0), m_nFseq(0),
+    m_nStartTime(0), m_nFramesFed(0)
+{
+}
+
+/** \param _nCursors The number of simultaneous cursors.
+* \param _fSpeed The speed of the cursors, in screen units ([0;1]) per second.
+* \param _fChurnRate The number of times per second each cursor is replaced, on average.
+* \param _fFrameRate The number of frames per second, as a tracker would send them.
+* \param _nSeed The seed of the pseudo-random generator.
+*/
+void ofxTactoSyntheticSource::setup(int _nCursors, float _fSpeed, float _fChurnRate, float _fFrameRate, unsigned int _nSeed)
+{
+    m_fSpeed = _fSpeed;
+    m_fChurnRate = _fChurnRate;
+    m_fFrameRate = _fFrameRate;
+    m_nRandomState = _nSeed ? _nSeed : 1;
+    m_nFseq = 0;
+    m_nFramesFed = 0;
+    m_nStartTime = ofGetElapsedTimeMicros();
+
+    m_cursors.resize(_nCursors);
+    for (int i = 0; i < _nCursors; i++)
+    {
+        placeCursor(m_cursors[i]);
+    }
+}
+
+/** \param _handler The handler that receives the frames.
+* \return The number of frames fed.
+*/
+int ofxTactoSyntheticSource::update(ofxTactoHandler& _handler)
+{
+    unsigned long long elapsed = ofGetElapsedTimeMicros() - m_nStartTime;
+    unsigned long long due = elapsed * m_fFrameRate / 1000000;
+    int nFed = 0;
+    while (m_nFramesFed < due)
+    {
+        emitFrame(_handler);
+        nFed++;
+    }
+    return nFed;
+}
+
+/** \param _handler The handler that receives the frame.
+*/
+void ofxTactoSyntheticSource::emitFrame(ofxTactoHandler& _handler)
+{
+    float dt = 1.0f / m_fFrameRate;
+    float churnProbability = m_fChurnRate * dt;
+
+    // Move, bounce and replace the cursors
+    for (unsigned int i = 0; i < m_cursors.size(); i++)
+    {
+        cursor& c = m_cursors[i];
+        if (random() < churnProbability)
+        {
+            placeCursor(c);
+            continue;
+        }
+        c.x += c.vx * dt;
+        c.y += c.vy * dt;
+        if (c.x < 0 || c.x > 1)
+        {
+            c.vx = -c.vx;
+            c.x = ofClamp(c.x, 0.0f, 1.0f);
+        }
+        if (c.y < 0 || c.y > 1)
+        {
+            c.vy = -c.vy;
+            c.y = ofClamp(c.y, 0.0f, 1.0f);
+        }
+    }
+
+    // Feed the frame as a TUIO cursor bundle
+    ofxTactoTuioRecord record;
+    record.time = ofGetElapsedTimeMicros();
+    record.profile = TUIO_PROFILE_CURSOR;
+    record.classId = 0;
+    record.width = record.height = record.accel = 0;
+    record.angle = record.rotationSpeed = 0;
+
+    record.type = TUIO_RECORD_ALIVE_BEGIN;
+    record.id = m_cursors.size();
+    _handler.injectRecord(record);
+    record.type = TUIO_RECORD_ALIVE;
+    for (unsigned int i = 0; i < m_cursors.size(); i++)
+    {
+        record.id = m_cursors[i].id;
+        _handler.injectRecord(record);
+    }
+    record.type = TUIO_RECORD_ALIVE_END;
+    record.id = m_cursors.size();
+    _handler.injectRecord(record);
+
+    record.type = TUIO_RECORD_SET;
+    for (unsigned int i = 0; i < m_cursors.size(); i++)
+    {
+        const cursor& c = m_cursors[i];
+        record.id = c.id;
+        record.x = c.x;
+        record.y = c.y;
+        record.vx = c.vx;
+        record.vy = c.vy;
+        _handler.injectRecord(record);
+    }
+
+    record.type = TUIO_RECORD_FSEQ;
+    record.id = m_nFseq++;
+    _handler.injectRecord(record);
+
+    m_nFramesFed++;
+}
+
+/** \return The number of simulated cursors.
+*/
+int ofxTactoSyntheticSource::getNumCursors()
+{
+    return m_cursors.size();
+}
+
+/** \note A linear congruential generator is used rather than ofRandom(), so that the
+* sequence does not depend on anything else the application draws.
+* \return A pseudo-random number in [0;1[.
+*/
+float ofxTactoSyntheticSource::random()
+{
+    m_nRandomState = m_nRandomState * 1664525u + 1013904223u;
+    return (m_nRandomState >> 8) / 16777216.0f;
+}
+
+/** \param _cursor The cursor to place.
+*/
+void ofxTactoSyntheticSource::placeCursor(cursor& _cursor)
+{
+    float angle = random() * TWO_PI;
+    _cursor.id = m_nNextId++;
+    _cursor.x = random();
+    _cursor.y = random();
+    _cursor.vx = m_fSpeed * cos(angle);
+    _cursor.vy = m_fSpeed * sin(angle);
+}
@@ -0,0 +1,58 @@
+#ifndef TACTOSYNTHETICSOURCE_H
+#define TACTOSYNTHETICSOURCE_H
+
+/**
+ * \class ofxTactoSyntheticSource
+ *
+ * \brief A generator of synthetic multi-touch load, fed to a handler as TUIO frames.
+ *
+ * The source simulates a number of cursors that move at a given speed, bounce on the edges
+ * of the table and are replaced (lifted and put down elsewhere) at a given churn rate. Each
+ * frame is fed to an \link ofxTactoHandler as a complete TUIO cursor bundle (alive, set...,
+ * fseq), so it goes through the same path as live data. The random sequence only depends on
+ * the seed, so two runs with the same parameters produce the same frames.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxTactoTuioRecord.h"
+#include "ofxTactoHandler.h"
+
+/// A class that generates synthetic cursors.
+class ofxTactoSyntheticSource
+{
+    public:
+        ofxTactoSyntheticSource(); ///< Constructor
+
+        void                setup(int _nCursors, float _fSpeed, float _fChurnRate, float _fFrameRate, unsigned int _nSeed = 1); ///< Configures the generated load.
+        int                 update(ofxTactoHandler& _handler); ///< Feeds the frames that are due in real time and returns how many were fed.
+        void                emitFrame(ofxTactoHandler& _handler); ///< Advances the simulation by one frame and feeds it to the handler.
+        int                 getNumCursors(); ///< Returns the number of simulated cursors.
+
+    private:
+        /// A simulated cursor.
+        struct cursor {
+            int id; ///< The session ID.
+            float x; ///< The x coordinate, in [0;1].
+            float y; ///< The y coordinate, in [0;1].
+            float vx; ///< The speed along axis x, per second.
+            float vy; ///< The speed along axis y, per second.
+        };
+
+        float               random(); ///< Returns a pseudo-random number in [0;1[.
+        void                placeCursor(cursor& _cursor); ///< Gives a cursor a new ID, position and direction.
+
+        vector<cursor>      m_cursors; ///< The simulated cursors.
+        float               m_fSpeed; ///< The speed of the cursors, in screen units per second.
+        float               m_fChurnRate; ///< The number of times per second each cursor is replaced, on average.
+        float               m_fFrameRate; ///< The number of frames per second.
+        unsigned int        m_nRandomState; ///< The state of the pseudo-random generator.
+        int                 m_nNextId; ///< The session ID of the next new cursor.
+        int                 m_nFseq; ///< The sequence number of the next frame.
+        unsigned long long  m_nStartTime; ///< The time at which the first frame was due.
+        unsigned long long  m_nFramesFed; ///< The number of frames fed so far.
+};
+
+#endif // TACTOSYNTHETICSOURCE_H
@@ -0,0 +1,43 @@
+#ifndef TACTOTOUCHEVENT_H
+#define TACTOTOUCHEVENT_H
+
+/**
+ * \class ofxTactoTouchEvent
+ *
+ * \brief A touch change (down, moved or up) produced by the touch system for a frame.
+ *
+ * All the changes of a frame are delivered at once through \link ofxTactoTouchBatchEventArgs,
+ * as a contiguous array, so that listeners can handle every touch in a single pass.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include "ofMain.h"
+
+/// The kinds of touch changes.
+enum TACTO_TOUCH_TYPE {
+    TACTO_TOUCH_DOWN, ///< A new point of contact.
+    TACTO_TOUCH_MOVED, ///< An existing point of contact was updated.
+    TACTO_TOUCH_UP, ///< A point of contact was lifted.
+};
+
+/// A class that describes one touch change.
+class ofxTactoTouchEvent
+{
+    public:
+        int             type; ///< The kind of change (see TACTO_TOUCH_TYPE).
+        int             id; ///< The ID of the touch point.
+        float           x; ///< The x coordinate of the touch point.
+        float           y; ///< The y coordinate of the touch point.
+};
+
+/// A class that carries all the touch changes of a frame.
+class ofxTactoTouchBatchEventArgs : public ofEventArgs
+{
+    public:
+        const ofxTactoTouchEvent* events; ///< The touch changes, in the order in which they happened (ups first).
+        int             numEvents; ///< The number of touch changes.
+};
+
+#endif // TACTOTOUCHEVENT_H
@@ -0,0 +1,173 @@
+#include "ofxTactoTuioPlayer.h"
+#include "ofxTactoTuioRecorder.h"
+
+ofxTactoTuioPlayer::ofxTactoTuioPlayer() :
+    m_nNext(0), m_fSpeed(1), m_bPlaying(false), m_bLoop(false), m_nStartTime(0), m_nFseqSpan(0), m_nFseqOffset(0), m_bPassStarted(false)
+{
+}
+
+/** \param _path The path of the file, relative to the data folder.
+* \return Whether or not the file is a valid recording.
+*/
+bool ofxTactoTuioPlayer::load(string _path)
+{
+    stop();
+    m_records.clear();
+
+    ifstream file(ofToDataPath(_path).c_str(), ios::in | ios::binary);
+    char magic[4];
+    unsigned int version = 0;
+    file.read(magic, 4);
+    file.read((char*)&version, sizeof(version));
+    if (!file || strncmp(magic, TUIO_RECORDING_MAGIC, 4) != 0 || version != TUIO_RECORDING_VERSION)
+    {
+        ofLogError() << "ofxTactoTuioPlayer: " << _path << " is not a TUIO recording";
+        return false;
+    }
+
+    int minFseq = 0;
+    int maxFseq = -1;
+    while (true)
+    {
+        ofxTactoTuioRecord record;
+        unsigned char type, profile;
+        file.read((char*)&record.time, sizeof(record.time));
+        file.read((char*)&type, sizeof(type));
+        file.read((char*)&profile, sizeof(profile));
+        file.read((char*)&record.id, sizeof(record.id));
+        if (!file)
+            break;
+        record.type = type;
+        record.profile = profile;
+        record.classId = 0;
+        record.x = record.y = record.vx = record.vy = 0;
+        record.width = record.height = record.accel = record.angle = record.rotationSpeed = 0;
+        if (record.type == TUIO_RECORD_SET)
+        {
+            float fields[9];
+            file.read((char*)&record.classId, sizeof(record.classId));
+            file.read((char*)fields, sizeof(fields));
+            if (!file)
+                break;
+            record.x = fields[0];
+            record.y = fields[1];
+            record.vx = fields[2];
+            record.vy = fields[3];
+            record.width = fields[4];
+            record.height = fields[5];
+            record.accel = fields[6];
+            record.angle = fields[7];
+            record.rotationSpeed = fields[8];
+        }
+        if (record.type == TUIO_RECORD_FSEQ && record.id != -1)
+        {
+            if (maxFseq < minFseq)
+                minFseq = maxFseq = record.id;
+            minFseq = min(minFseq, record.id);
+            maxFseq = max(maxFseq, record.id);
+        }
+        m_records.push_back(record);
+    }
+    m_nFseqSpan = maxFseq - minFseq + 1;
+    return true;
+}
+
+/** \note The frame sequence numbers keep increasing from one replay to the next, so that replaying
+* into the same handler again does not make it drop frames as stale.
+*/
+void ofxTactoTuioPlayer::play()
+{
+    if (m_bPassStarted)
+        m_nFseqOffset += m_nFseqSpan;
+    m_bPassStarted = true;
+    m_nNext = 0;
+    m_nStartTime = ofGetElapsedTimeMicros();
+    m_bPlaying = true;
+}
+
+void ofxTactoTuioPlayer::stop()
+{
+    m_bPlaying = false;
+}
+
+/** \return Whether or not the replay is running.
+*/
+bool ofxTactoTuioPlayer::isPlaying()
+{
+    return m_bPlaying;
+}
+
+/** \param _fSpeed The replay speed: 1 is real time, 2 is twice as fast, and 0 feeds the whole recording at once.
+*/
+void ofxTactoTuioPlayer::setSpeed(float _fSpeed)
+{
+    m_fSpeed = _fSpeed;
+}
+
+/** \param _bLoop Whether or not the replay starts over when it reaches the end.
+*/
+void ofxTactoTuioPlayer::setLoop(bool _bLoop)
+{
+    m_bLoop = _bLoop;
+}
+
+/** \note Replayed records are stamped with the time at which they are fed. Frame sequence numbers
+* are shifted on every pass (loop or play()), so that the handler does not drop them as stale.
+* \param _handler The handler that receives the records.
+* \return The number of records fed.
+*/
+int ofxTactoTuioPlayer::update(ofxTactoHandler& _handler)
+{
+    if (!m_bPlaying)
+        return 0;
+
+    unsigned long long now = ofGetElapsedTimeMicros();
+    unsigned long long elapsed = now - m_nStartTime;
+    int nFed = 0;
+    while (m_bPlaying)
+    {
+        if (m_nNext >= (int)m_records.size())
+        {
+            if (!m_bLoop || m_records.empty())
+            {
+                m_bPlaying = false;
+                break;
+            }
+            // Start the next pass
+            m_nNext = 0;
+            m_nFseqOffset += m_nFseqSpan;
+            m_nStartTime = now;
+            elapsed = 0;
+            // As fast as possible means one whole pass per call
+            if (m_fSpeed <= 0)
+                break;
+        }
+
+        ofxTactoTuioRecord record = m_records[m_nNext];
+        // In double precision: microsecond times outgrow the 24 bits of a float after 17 seconds
+        if (m_fSpeed > 0 && (double)record.time > (double)elapsed * m_fSpeed)
+            break;
+
+        record.time = now;
+        if (record.type == TUIO_RECORD_FSEQ && record.id != -1)
+            record.id += m_nFseqOffset;
+        _handler.injectRecord(record);
+        m_nNext++;
+        nFed++;
+    }
+    return nFed;
+}
+
+/** \return The number of records in the recording.
+*/
+int ofxTactoTuioPlayer::getNumRecords()
+{
+    return m_records.size();
+}
+
+/** \return The time of the last record, in microseconds.
+*/
+unsigned long long ofxTactoTuioPlayer::getDuration()
+{
+    return m_records.empty() ? 0 : m_records.back().time;
+}
@@ -0,0 +1,50 @@
+#ifndef TACTOTUIOPLAYER_H
+#define TACTOTUIOPLAYER_H
+
+/**
+ * \class ofxTactoTuioPlayer
+ *
+ * \brief A class that replays a TUIO recording (see \link ofxTactoTuioRecorder) into a handler.
+ *
+ * The recording is loaded in memory, then fed to an \link ofxTactoHandler from update(), either
+ * at its recorded pace (speed 1), accelerated (speed above 1), or as fast as possible (speed 0),
+ * in which case every remaining record is fed at once. The timing only depends on the recorded
+ * times and the speed, so a replay produces the same frames every time.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxTactoTuioRecord.h"
+#include "ofxTactoHandler.h"
+
+/// A class that replays recorded TUIO data.
+class ofxTactoTuioPlayer
+{
+    public:
+        ofxTactoTuioPlayer(); ///< Constructor
+
+        bool                load(string _path); ///< Loads a recording.
+        void                play(); ///< Starts (or restarts) the replay from the beginning.
+        void                stop(); ///< Stops the replay.
+        bool                isPlaying(); ///< Returns true if and only if the replay is running.
+        void                setSpeed(float _fSpeed); ///< Sets the replay speed (1 is real time, 0 is as fast as possible).
+        void                setLoop(bool _bLoop); ///< Makes the replay start over when it reaches the end, or not.
+        int                 update(ofxTactoHandler& _handler); ///< Feeds the records that are due to the handler and returns how many were fed.
+        int                 getNumRecords(); ///< Returns the number of records in the recording.
+        unsigned long long  getDuration(); ///< Returns the duration of the recording, in microseconds.
+
+    private:
+        vector<ofxTactoTuioRecord> m_records; ///< The recording, with times relative to its start.
+        int                 m_nNext; ///< The index of the next record to feed.
+        float               m_fSpeed; ///< The replay speed.
+        bool                m_bPlaying; ///< Whether or not the replay is running.
+        bool                m_bLoop; ///< Whether or not the replay starts over at the end.
+        unsigned long long  m_nStartTime; ///< The time at which the current pass started.
+        int                 m_nFseqSpan; ///< The range of frame sequence numbers in the recording.
+        int                 m_nFseqOffset; ///< The shift of the frame sequence numbers of the current pass (never decreases).
+        bool                m_bPassStarted; ///< Whether or not a pass was started since the player was created.
+};
+
+#endif // TACTOTUIOPLAYER_H
@@ -0,0 +1,157 @@
+#include "ofxTactoTuioReceiver.h"
+
+/** \param _nPort The UDP port on which TUIO data is received.
+*/
+void ofxTactoTuioReceiver::setup(int _nPort)
+{
+    m_receiver.setup(_nPort);
+    m_decoded.reserve(TUIO_QUEUE_CAPACITY);
+    startThread();
+}
+
+void ofxTactoTuioReceiver::stop()
+{
+    if (isThreadRunning())
+    {
+        waitForThread(true);
+    }
+}
+
+/** \param _record Receives the next record.
+* \return Whether or not a record was available.
+*/
+bool ofxTactoTuioReceiver::popRecord(ofxTactoTuioRecord& _record)
+{
+    return m_queue.pop(_record);
+}
+
+void ofxTactoTuioReceiver::threadedFunction()
+{
+    ofxOscMessage m;
+    while (isThreadRunning())
+    {
+        if (!m_receiver.hasWaitingMessages())
+        {
+            sleep(1);
+            continue;
+        }
+        m_receiver.getNextMessage(&m);
+
+        m_decoded.clear();
+        decode(m, m_decoded, ofGetElapsedTimeMicros());
+
+        // Wait for the consumer whenever the queue is full, rather than dropping records
+        for (unsigned int i = 0; i < m_decoded.size(); i++)
+        {
+            while (!m_queue.push(m_decoded[i]) && isThreadRunning())
+            {
+                sleep(1);
+            }
+        }
+    }
+}
+
+/** \note A cursor "set" message may carry the height, width and acceleration of the cursor
+* after its velocity. Objects and shapes follow the TUIO 1.1 specification.
+* \param _m The OSC message to decode.
+* \param _records The vector to which the decoded records are appended.
+* \param _nTime The time (microseconds) at which the message was received.
+*/
+void ofxTactoTuioReceiver::decode(const ofxOscMessage& _m, vector<ofxTactoTuioRecord>& _records, unsigned long long _nTime)
+{
+    ofxTactoTuioRecord record;
+    record.time = _nTime;
+    string address = _m.getAddress();
+    if (address == "/tuio/2Dcur")
+        record.profile = TUIO_PROFILE_CURSOR;
+    else if (address == "/tuio/2Dobj")
+        record.profile = TUIO_PROFILE_OBJECT;
+    else if (address == "/tuio/2Dblb")
+        record.profile = TUIO_PROFILE_SHAPE;
+    else
+        return;
+
+    int numArgs = _m.getNumArgs();
+    string msg = _m.getArgAsString(0);
+    if (msg == "set")
+    {
+        record.type = TUIO_RECORD_SET;
+        record.id = _m.getArgAsInt32(1);
+        record.classId = 0;
+        record.vx = 0;
+        record.vy = 0;
+        record.width = 0;
+        record.height = 0;
+        record.accel = 0;
+        record.angle = 0;
+        record.rotationSpeed = 0;
+        switch (record.profile)
+        {
+            case TUIO_PROFILE_CURSOR:
+                // set s x y X Y [height width accel]
+                record.x = _m.getArgAsFloat(2);
+                record.y = _m.getArgAsFloat(3);
+                record.vx = _m.getArgAsFloat(4);
+                record.vy = _m.getArgAsFloat(5);
+                if (numArgs > 6)
+                    record.height = _m.getArgAsFloat(6);
+                if (numArgs > 7)
+                    record.width = _m.getArgAsFloat(7);
+                if (numArgs > 8)
+                    record.accel = _m.getArgAsFloat(8);
+                break;
+            case TUIO_PROFILE_OBJECT:
+                // set s i x y a X Y A m r
+                if (numArgs < 11)
+                    return;
+                record.classId = _m.getArgAsInt32(2);
+                record.x = _m.getArgAsFloat(3);
+                record.y = _m.getArgAsFloat(4);
+                record.angle = _m.getArgAsFloat(5);
+                record.vx = _m.getArgAsFloat(6);
+                record.vy = _m.getArgAsFloat(7);
+                record.rotationSpeed = _m.getArgAsFloat(8);
+                record.accel = _m.getArgAsFloat(9);
+                break;
+            case TUIO_PROFILE_SHAPE:
+                // set s x y a w h f X Y A m r
+                if (numArgs < 13)
+                    return;
+                record.x = _m.getArgAsFloat(2);
+                record.y = _m.getArgAsFloat(3);
+                record.angle = _m.getArgAsFloat(4);
+                record.width = _m.getArgAsFloat(5);
+                record.height = _m.getArgAsFloat(6);
+                record.vx = _m.getArgAsFloat(8);
+                record.vy = _m.getArgAsFloat(9);
+                record.rotationSpeed = _m.getArgAsFloat(10);
+                record.accel = _m.getArgAsFloat(11);
+                break;
+            default:
+                break;
+        }
+        _records.push_back(record);
+    }
+    else if (msg == "alive")
+    {
+        int numAliveBlobs = numArgs - 1;
+        record.type = TUIO_RECORD_ALIVE_BEGIN;
+        record.id = numAliveBlobs;
+        _records.push_back(record);
+        record.type = TUIO_RECORD_ALIVE;
+        for (int i = 0; i < numAliveBlobs; i++)
+        {
+            record.id = _m.getArgAsInt32(i + 1);
+            _records.push_back(record);
+        }
+        record.type = TUIO_RECORD_ALIVE_END;
+        record.id = numAliveBlobs;
+        _records.push_back(record);
+    }
+    else if (msg == "fseq")
+    {
+        record.type = TUIO_RECORD_FSEQ;
+        record.id = _m.getArgAsInt32(1);
+        _records.push_back(record);
+    }
+}
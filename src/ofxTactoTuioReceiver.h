@@ -0,0 +1,42 @@
+#ifndef TACTOTUIORECEIVER_H
+#define TACTOTUIORECEIVER_H
+
+/**
+ * \class ofxTactoTuioReceiver
+ *
+ * \brief A background thread that receives and decodes TUIO messages.
+ *
+ * The thread reads the OSC packets, decodes them into \link ofxTactoTuioRecord records and
+ * pushes them into a lock-free single-producer/single-consumer queue. The consumer (usually
+ * \link ofxTactoHandler::update() on the main thread) pops the records with popRecord().
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+#include "ofxTactoTuioRecord.h"
+#include "ofxTactoSpscQueue.h"
+
+#define TUIO_QUEUE_CAPACITY 4096
+
+/// A class that receives TUIO data on its own thread.
+class ofxTactoTuioReceiver : public ofThread
+{
+    public:
+        void                setup(int _nPort); ///< Opens the port and starts the thread.
+        void                stop(); ///< Stops the thread and waits for it to finish.
+        bool                popRecord(ofxTactoTuioRecord& _record); ///< Pops the next decoded record. Called by the consumer thread only.
+
+        static void         decode(const ofxOscMessage& _m, vector<ofxTactoTuioRecord>& _records, unsigned long long _nTime); ///< Static function that decodes a TUIO message and appends the resulting records.
+
+    private:
+        void                threadedFunction(); ///< The receive loop.
+
+        ofxOscReceiver      m_receiver; ///< The OSC packet listener that reads TUIO data.
+        vector<ofxTactoTuioRecord> m_decoded; ///< Scratch buffer for the records of one message (reused to avoid allocations).
+        ofxTactoSpscQueue<ofxTactoTuioRecord, TUIO_QUEUE_CAPACITY> m_queue; ///< The queue between this thread and the consumer.
+};
+
+#endif // TACTOTUIORECEIVER_H
@@ -0,0 +1,58 @@
+#ifndef TACTOTUIORECORD_H
+#define TACTOTUIORECORD_H
+
+/**
+ * \class ofxTactoTuioRecord
+ *
+ * \brief A compact, decoded form of a TUIO message.
+ *
+ * Records come from the 2Dcur (cursor), 2Dobj (object) and 2Dblb (shape) profiles; the
+ * profile field tells them apart.
+ *
+ * A "set" message becomes one TUIO_RECORD_SET record. An "alive" message becomes a
+ * TUIO_RECORD_ALIVE_BEGIN record, one TUIO_RECORD_ALIVE record per session ID, and a
+ * TUIO_RECORD_ALIVE_END record. An "fseq" message, which closes a TUIO bundle, becomes
+ * a TUIO_RECORD_FSEQ record carrying the frame sequence number. Records are plain data, so they can cross threads by copy.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+/// The kinds of decoded TUIO records.
+enum TUIO_RECORD_TYPE {
+    TUIO_RECORD_SET, ///< The state of one cursor.
+    TUIO_RECORD_ALIVE_BEGIN, ///< The start of an alive set.
+    TUIO_RECORD_ALIVE, ///< One session ID of an alive set.
+    TUIO_RECORD_ALIVE_END, ///< The end of an alive set.
+    TUIO_RECORD_FSEQ, ///< The end of a frame, with its sequence number in id.
+};
+
+/// The TUIO profiles that are decoded.
+enum TUIO_PROFILE {
+    TUIO_PROFILE_CURSOR, ///< /tuio/2Dcur: fingers.
+    TUIO_PROFILE_OBJECT, ///< /tuio/2Dobj: tagged tangibles (fiducials).
+    TUIO_PROFILE_SHAPE, ///< /tuio/2Dblb: untagged shapes.
+    TUIO_PROFILE_COUNT, ///< The number of profiles.
+};
+
+/// A class that holds one decoded TUIO record.
+class ofxTactoTuioRecord
+{
+    public:
+        unsigned long long time; ///< The time (microseconds since the application started) at which the message was received.
+        int             type; ///< The kind of record (see TUIO_RECORD_TYPE).
+        int             profile; ///< The profile of the record (see TUIO_PROFILE).
+        int             id; ///< The session ID of the cursor (or the frame sequence number).
+        int             classId; ///< The class (fiducial) ID of an object.
+        float           x; ///< The x coordinate of the cursor.
+        float           y; ///< The y coordinate of the cursor.
+        float           vx; ///< The speed along axis x of the cursor.
+        float           vy; ///< The speed along axis y of the cursor.
+        float           width; ///< The width of the cursor.
+        float           height; ///< The height of the cursor.
+        float           accel; ///< The acceleration of the cursor.
+        float           angle; ///< The angle of an object or a shape, in radians.
+        float           rotationSpeed; ///< The rotation speed of an object or a shape.
+};
+
+#endif // TACTOTUIORECORD_H
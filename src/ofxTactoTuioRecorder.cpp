@@ -0,0 +1,80 @@
+#include "ofxTactoTuioRecorder.h"
+
+ofxTactoTuioRecorder::ofxTactoTuioRecorder() : m_bFirst(true), m_nStartTime(0), m_nNumRecords(0)
+{
+}
+
+ofxTactoTuioRecorder::~ofxTactoTuioRecorder()
+{
+    stop();
+}
+
+/** \param _path The path of the file, relative to the data folder.
+* \return Whether or not the file could be opened.
+*/
+bool ofxTactoTuioRecorder::start(string _path)
+{
+    stop();
+    m_file.open(ofToDataPath(_path).c_str(), ios::out | ios::binary | ios::trunc);
+    if (!m_file.is_open())
+        return false;
+
+    unsigned int version = TUIO_RECORDING_VERSION;
+    m_file.write(TUIO_RECORDING_MAGIC, 4);
+    m_file.write((const char*)&version, sizeof(version));
+    m_bFirst = true;
+    m_nNumRecords = 0;
+    return true;
+}
+
+void ofxTactoTuioRecorder::stop()
+{
+    if (m_file.is_open())
+    {
+        m_file.close();
+    }
+}
+
+/** \return Whether or not records are being written to a file.
+*/
+bool ofxTactoTuioRecorder::isRecording()
+{
+    return m_file.is_open();
+}
+
+/** \param _record The record to append.
+*/
+void ofxTactoTuioRecorder::write(const ofxTactoTuioRecord& _record)
+{
+    if (!m_file.is_open())
+        return;
+
+    if (m_bFirst)
+    {
+        m_nStartTime = _record.time;
+        m_bFirst = false;
+    }
+
+    unsigned long long time = _record.time - m_nStartTime;
+    unsigned char type = _record.type;
+    unsigned char profile = _record.profile;
+    m_file.write((const char*)&time, sizeof(time));
+    m_file.write((const char*)&type, sizeof(type));
+    m_file.write((const char*)&profile, sizeof(profile));
+    m_file.write((const char*)&_record.id, sizeof(_record.id));
+    if (_record.type == TUIO_RECORD_SET)
+    {
+        float fields[9] = { _record.x, _record.y, _record.vx, _record.vy, _record.width, _record.height,
+            _record.accel, _record.angle, _record.rotationSpeed };
+        m_file.write((const char*)&_record.classId, sizeof(_record.classId));
+        m_file.write((const char*)fields, sizeof(fields));
+    }
+    m_nNumRecords++;
+}
+
+/** \return The number of records written since the last call to start().
+*/
+int ofxTactoTuioRecorder::getNumRecords()
+{
+    return m_nNumRecords;
+}
@@ -0,0 +1,48 @@
+#ifndef TACTOTUIORECORDER_H
+#define TACTOTUIORECORDER_H
+
+/**
+ * \class ofxTactoTuioRecorder
+ *
+ * \brief A class that writes decoded TUIO records to a compact binary file.
+ *
+ * The file starts with the four characters "TTSR" and a 32-bit format version, followed by
+ * one entry per record: the time in microseconds since the first record (64 bits), the record
+ * type and profile (8 bits each) and the session ID (32 bits). "set" entries then carry the
+ * class ID (32 bits) and the nine floats of the record (x, y, vx, vy, width, height, accel,
+ * angle, rotationSpeed). Numbers are written in host byte order.
+ *
+ * Attach the recorder to a handler with \link ofxTactoHandler::setRecorder(), and replay the
+ * file with \link ofxTactoTuioPlayer.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxTactoTuioRecord.h"
+
+#define TUIO_RECORDING_MAGIC "TTSR"
+#define TUIO_RECORDING_VERSION 1
+
+/// A class that records TUIO data to a file.
+class ofxTactoTuioRecorder
+{
+    public:
+        ofxTactoTuioRecorder(); ///< Constructor
+        ~ofxTactoTuioRecorder(); ///< Destructor
+
+        bool                start(string _path); ///< Opens (and truncates) the file to record to.
+        void                stop(); ///< Closes the file.
+        bool                isRecording(); ///< Returns true if and only if a file is open.
+        void                write(const ofxTactoTuioRecord& _record); ///< Appends a record to the file.
+        int                 getNumRecords(); ///< Returns the number of records written since start().
+
+    private:
+        ofstream            m_file; ///< The file being written.
+        bool                m_bFirst; ///< Whether or not the next record is the first one.
+        unsigned long long  m_nStartTime; ///< The time of the first record.
+        int                 m_nNumRecords; ///< The number of records written.
+};
+
+#endif // TACTOTUIORECORDER_H
@@ -0,0 +1,233 @@
+#include "ofxTactoTuioTracker.h"
+
+ofxTactoTuioTracker::ofxTactoTuioTracker() : m_bFrameHasAlive(false), m_nLastFseq(-1), m_bFrameStarted(false), m_nFrameStartTime(0), m_nAppliedFrameStartTime(0), m_nFrameTime(0)
+{
+}
+
+/** \note TUIO messages come in bundles (alive, set..., fseq). Records are gathered until the
+* fseq record closes the bundle, so that the frame can be applied as a whole. A broken sender or
+* a cut recording may never close it: when TUIO_MAX_PENDING_RECORDS set records are pending, the
+* frame is applied as if an fseq of -1 had come, and alive records past that number are ignored.
+* \param _record The decoded TUIO record.
+* \return Whether or not a frame was applied, in which case getFrameEvents() holds its changes.
+*/
+bool ofxTactoTuioTracker::applyRecord(const ofxTactoTuioRecord& _record)
+{
+    bool bApplied = false;
+    if (_record.type != TUIO_RECORD_ALIVE_BEGIN)
+    {
+        m_nFrameTime = _record.time;
+        if (!m_bFrameStarted)
+        {
+            m_bFrameStarted = true;
+            m_nFrameStartTime = _record.time;
+        }
+    }
+    switch (_record.type)
+    {
+        case TUIO_RECORD_SET:
+            if (m_frameSets.size() >= TUIO_MAX_PENDING_RECORDS)
+            {
+                // The frame is never closed: apply what it holds
+                bApplied = applyFrame(-1);
+                m_bFrameStarted = true;
+                m_nFrameStartTime = _record.time;
+            }
+            m_frameSets.push_back(_record);
+            break;
+        case TUIO_RECORD_ALIVE_BEGIN:
+            if (m_bFrameHasAlive)
+            {
+                // A new bundle started without an fseq for the previous one
+                bApplied = applyFrame(-1);
+            }
+            m_bFrameHasAlive = true;
+            m_frameAlive.clear();
+            m_bFrameStarted = true;
+            m_nFrameStartTime = _record.time;
+            break;
+        case TUIO_RECORD_ALIVE:
+            if (m_frameAlive.size() < TUIO_MAX_PENDING_RECORDS)
+                m_frameAlive.push_back(_record.id);
+            break;
+        case TUIO_RECORD_FSEQ:
+            bApplied = applyFrame(_record.id);
+            break;
+        default:
+            break;
+    }
+    return bApplied;
+}
+
+/** \return The number of set and alive records of the pending frame, at most TUIO_MAX_PENDING_RECORDS of each.
+*/
+int ofxTactoTuioTracker::getNumPendingRecords() const
+{
+    return m_frameSets.size() + m_frameAlive.size();
+}
+
+/** \note Down and moved changes report the final position of the entity in the frame.
+* \return The touch changes of the last applied frame (ups first).
+*/
+const vector<ofxTactoTouchEvent>& ofxTactoTuioTracker::getFrameEvents() const
+{
+    return m_frameEvents;
+}
+
+/** \return The table of tracked entities.
+*/
+const ofxTactoBlobTable& ofxTactoTuioTracker::getTable() const
+{
+    return m_table;
+}
+
+/** \note The view reflects the last applied frame and stays valid until the next applied frame.
+* \return A view over the tracked entities.
+*/
+ofxTactoBlobView ofxTactoTuioTracker::getView() const
+{
+    return ofxTactoBlobView(m_packedBlobs.empty() ? NULL : &m_packedBlobs[0], m_packedBlobs.size());
+}
+
+/** \return The snapshot of the tracked entities.
+*/
+ofxTactoBlobSnapshot& ofxTactoTuioTracker::getSnapshot()
+{
+    return m_snapshot;
+}
+
+/** \note This is the receipt time of the oldest record of the frame, from which its latency is measured.
+* \return The time at which the last applied frame started to be received, in microseconds.
+*/
+unsigned long long ofxTactoTuioTracker::getFrameReceiptTime() const
+{
+    return m_nAppliedFrameStartTime;
+}
+
+/** \return The smoothing and prediction stage of the positions, disabled by default.
+*/
+ofxTactoCursorFilter& ofxTactoTuioTracker::getFilter()
+{
+    return m_filter;
+}
+
+/** \note As in the TUIO reference implementation, a frame is stale when its sequence number is
+* not newer than the last applied one, unless it is -1 (always applied) or far enough behind to
+* mean that the tracker restarted.
+* \param _fseq The sequence number of the frame.
+* \return Whether or not the frame was applied.
+*/
+bool ofxTactoTuioTracker::applyFrame(int _fseq)
+{
+    bool bStale = _fseq != -1 && _fseq <= m_nLastFseq && m_nLastFseq - _fseq <= TUIO_FSEQ_RESTART_WINDOW;
+    if (!bStale)
+    {
+        if (_fseq != -1)
+            m_nLastFseq = _fseq;
+        m_nAppliedFrameStartTime = m_nFrameStartTime;
+
+        m_frameEvents.clear();
+        m_table.beginFrame();
+
+        // Remove the entities that left, first
+        if (m_bFrameHasAlive)
+        {
+            m_table.beginMark();
+            for (unsigned int i = 0; i < m_frameAlive.size(); i++)
+            {
+                // Stamp every entity that is still alive
+                m_table.mark(m_frameAlive[i]);
+            }
+            manageBlobs();
+        }
+
+        // Then add or update the others. An entity set twice in the frame keeps its last state
+        // and produces a single change.
+        for (unsigned int i = 0; i < m_frameSets.size(); i++)
+        {
+            const ofxTactoTuioRecord& record = m_frameSets[i];
+            int slot = m_table.find(record.id);
+            if (slot < 0)
+            {
+                // Add the current entity
+                ofxTactoBlob newBlob(record.id, record.x, record.y, record.vx, record.vy, record.width, record.height, record.accel);
+                newBlob.classId = record.classId;
+                newBlob.angle = record.angle;
+                newBlob.rotationSpeed = record.rotationSpeed;
+                m_table.insert(newBlob);
+                m_table.markUpdated(record.id);
+                ofxTactoTouchEvent event = { TACTO_TOUCH_DOWN, record.id, record.x, record.y };
+                m_frameEvents.push_back(event);
+            }
+            else
+            {
+                // Exists, so update its info
+                m_table.set(slot, record.x, record.y, record.vx, record.vy, record.width, record.height, record.accel);
+                m_table.setOrientation(slot, record.classId, record.angle, record.rotationSpeed);
+                if (m_table.markUpdated(record.id))
+                {
+                    ofxTactoTouchEvent event = { TACTO_TOUCH_MOVED, record.id, record.x, record.y };
+                    m_frameEvents.push_back(event);
+                }
+            }
+        }
+
+        // Report the final positions, filtered if need be
+        bool bFilter = m_filter.isEnabled();
+        for (unsigned int i = 0; i < m_frameEvents.size(); i++)
+        {
+            ofxTactoTouchEvent& event = m_frameEvents[i];
+            if (event.type != TACTO_TOUCH_UP)
+            {
+                int slot = m_table.find(event.id);
+                event.x = m_table.xs()[slot];
+                event.y = m_table.ys()[slot];
+                if (bFilter)
+                {
+                    if (event.type == TACTO_TOUCH_DOWN)
+                        m_filter.reset(slot, event.x, event.y, m_table.vxs()[slot], m_table.vys()[slot], m_nFrameTime);
+                    else
+                        m_filter.filter(slot, event.x, event.y, m_table.vxs()[slot], m_table.vys()[slot], m_nFrameTime);
+                    m_table.setPosition(slot, event.x, event.y);
+                }
+            }
+        }
+
+        publishBlobs();
+    }
+
+    m_frameSets.clear();
+    m_frameAlive.clear();
+    m_bFrameHasAlive = false;
+    m_bFrameStarted = false;
+    return !bStale;
+}
+
+void ofxTactoTuioTracker::manageBlobs()
+{
+    // Sweep the table of maintained entities and remove those that were not stamped.
+    // Go backwards, since erasing reorders the entities that come after.
+    for (int i = m_table.size() - 1; i >= 0; i--)
+    {
+        if (!m_table.isMarked(i))
+        {
+            ofxTactoBlob blob = m_table[i];
+            ofxTactoTouchEvent event = { TACTO_TOUCH_UP, blob.id, blob.x, blob.y };
+            m_frameEvents.push_back(event);
+            m_table.erase(blob.id);
+        }
+    }
+}
+
+void ofxTactoTuioTracker::publishBlobs()
+{
+    m_packedBlobs.clear();
+    vector<ofxTactoBlob>& snapshotBlobs = m_snapshot.beginWrite();
+    for (int i = 0; i < m_table.size(); i++)
+    {
+        ofxTactoBlob blob = m_table[i];
+        m_packedBlobs.push_back(blob);
+        snapshotBlobs.push_back(blob);
+    }
+    m_snapshot.publish();
+}
@@ -0,0 +1,69 @@
+#ifndef TACTOTUIOTRACKER_H
+#define TACTOTUIOTRACKER_H
+
+/**
+ * \class ofxTactoTuioTracker
+ *
+ * \brief The tracked state of one TUIO profile (cursors, objects or shapes).
+ *
+ * The tracker gathers the decoded records of a TUIO bundle (alive, set..., fseq) into a
+ * pending frame, drops stale frames by sequence number, and applies the others as a whole
+ * to its \link ofxTactoBlobTable table. The touch changes of the last applied frame are
+ * available through getFrameEvents(), and the resulting entities through getView() and
+ * getSnapshot(). Once the buffers are warmed up, no memory is allocated per frame. A stream
+ * that never closes its frames cannot grow the buffers past TUIO_MAX_PENDING_RECORDS.
+ *
+ * When its \link ofxTactoCursorFilter filter is enabled, the positions are smoothed (and
+ * predicted) before they are stored, so the events, the view and the snapshot all agree.
+ *
+ * \author Bruno Angeles (bruno.angeles@mail.mcgill.ca)
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxTactoBlob.h"
+#include "ofxTactoBlobTable.h"
+#include "ofxTactoBlobSnapshot.h"
+#include "ofxTactoTuioRecord.h"
+#include "ofxTactoTouchEvent.h"
+#include "ofxTactoCursorFilter.h"
+
+#define TUIO_FSEQ_RESTART_WINDOW 100
+#define TUIO_MAX_PENDING_RECORDS 4096 ///< The largest number of set or alive records a pending frame holds
+
+/// A class that tracks the entities of one TUIO profile.
+class ofxTactoTuioTracker
+{
+    public:
+        ofxTactoTuioTracker(); ///< Constructor
+
+        bool                applyRecord(const ofxTactoTuioRecord& _record); ///< Accumulates a record. Returns true when it completed a frame that was applied.
+        const vector<ofxTactoTouchEvent>& getFrameEvents() const; ///< Returns the touch changes of the last applied frame.
+        const ofxTactoBlobTable& getTable() const; ///< Returns the table of tracked entities.
+        ofxTactoBlobView    getView() const; ///< Returns a read-only view of the tracked entities, without copying them.
+        ofxTactoBlobSnapshot& getSnapshot(); ///< Returns the snapshot of the tracked entities that another thread can read without locks.
+        unsigned long long  getFrameReceiptTime() const; ///< Returns the time at which the last applied frame started to be received.
+        int                 getNumPendingRecords() const; ///< Returns the number of set and alive records gathered for the pending frame.
+        ofxTactoCursorFilter& getFilter(); ///< Returns the smoothing and prediction stage of the positions.
+
+    private:
+        bool                applyFrame(int _fseq); ///< Applies the pending frame, unless it is stale. Returns true if it was applied.
+        void                manageBlobs(); ///< Removes the entities that were not in the last alive set.
+        void                publishBlobs(); ///< Packs the entities contiguously and publishes them to the snapshot.
+
+        vector<int>         m_frameAlive; ///< The alive set of the pending frame.
+        bool                m_bFrameHasAlive; ///< Whether or not the pending frame has an alive set.
+        vector<ofxTactoTuioRecord> m_frameSets; ///< The set records of the pending frame.
+        vector<ofxTactoTouchEvent> m_frameEvents; ///< The touch changes produced by the last applied frame.
+        int                 m_nLastFseq; ///< The sequence number of the last applied frame.
+        bool                m_bFrameStarted; ///< Whether or not a record of the pending frame was received.
+        unsigned long long  m_nFrameStartTime; ///< The time of the first record of the pending frame, in microseconds.
+        unsigned long long  m_nAppliedFrameStartTime; ///< The time of the first record of the last applied frame, in microseconds.
+        unsigned long long  m_nFrameTime; ///< The time of the last record of the pending frame, in microseconds.
+        ofxTactoCursorFilter m_filter; ///< The smoothing and prediction stage of the positions.
+        ofxTactoBlobTable   m_table; ///< The tracked entities, indexed by session ID.
+        vector<ofxTactoBlob> m_packedBlobs; ///< The tracked entities, packed contiguously after each frame.
+        ofxTactoBlobSnapshot m_snapshot; ///< The tracked entities, as published for other threads.
+};
+
+#endif // TACTOTUIOTRACKER_H